@@ -0,0 +1,81 @@
+/**
+ * @file arena.cpp
+ * @brief Implementation of the thread-local arena allocator.
+ */
+
+ #include "arena.hpp"
+ #include "globals.hpp"
+ #include <algorithm>
+
+ /**
+  * @brief Constructs an empty arena.
+  * @param chunkSize Default size (in bytes) of a newly allocated chunk.
+  */
+ Arena::Arena(size_t chunkSize) : current(0), offset(0), chunkSize(chunkSize), allocated(0) {}
+
+ /**
+  * @brief Allocates uninitialized memory from the arena.
+  *
+  * Moves on to the next retained chunk when the current one is full; a new chunk is
+  * only allocated from the heap (and counted in arenaChunkAllocations) when no
+  * retained chunk is large enough.
+  *
+  * @param bytes Number of bytes.
+  * @param align Required alignment (a power of two).
+  * @return Pointer to the memory.
+  */
+ void *Arena::allocate(size_t bytes, size_t align) {
+     allocated += bytes;
+     while (true) {
+         if (current < chunks.size()) {
+             size_t start = (offset + align - 1) & ~(align - 1);
+             if (start + bytes <= chunks[current].size) {
+                 offset = start + bytes;
+                 return chunks[current].data.get() + start;
+             }
+             if (current + 1 < chunks.size() && chunks[current + 1].size >= bytes + align) {
+                 current++;
+                 offset = 0;
+                 continue;
+             }
+         }
+         // No retained chunk fits: insert a new one after the current chunk.
+         size_t size = std::max(chunkSize, bytes + align);
+         size_t at = chunks.empty() ? 0 : current + 1;
+         chunks.insert(chunks.begin() + at, Chunk{std::unique_ptr<char[]>(new char[size]), size});
+         arenaChunkAllocations++;
+         current = at;
+         offset = 0;
+     }
+ }
+
+ /**
+  * @brief Returns the current position of the arena.
+  */
+ Arena::Mark Arena::mark() const {
+     return {current, offset};
+ }
+
+ /**
+  * @brief Releases everything allocated after the given mark.
+  * @param m A mark previously returned by mark().
+  */
+ void Arena::release(const Mark &m) {
+     current = m.chunk;
+     offset = m.offset;
+ }
+
+ /**
+  * @brief Total number of bytes handed out by this arena.
+  */
+ long long Arena::bytesAllocated() const {
+     return allocated;
+ }
+
+ /**
+  * @brief Returns the arena of the calling thread.
+  */
+ Arena &threadArena() {
+     thread_local Arena arena;
+     return arena;
+ }
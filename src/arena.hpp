@@ -0,0 +1,139 @@
+/**
+ * @file arena.hpp
+ * @brief Declaration of the thread-local arena allocator used for per-node scratch data.
+ */
+
+ #ifndef ARENA_HPP
+ #define ARENA_HPP
+
+ #include <cstddef>
+ #include <memory>
+ #include <vector>
+
+ /**
+  * @brief A chunked bump allocator with stack-like (mark/release) deallocation.
+  *
+  * Chunks are kept after a release and reused, so once an arena has grown to the
+  * working-set size of a subtree no further heap allocation happens.
+  */
+ class Arena {
+ public:
+     /**
+      * @brief Position in the arena, used to release everything allocated after it.
+      */
+     struct Mark {
+         size_t chunk;   ///< Index of the current chunk.
+         size_t offset;  ///< Offset within the current chunk.
+     };
+
+     /**
+      * @brief Constructs an empty arena.
+      * @param chunkSize Default size (in bytes) of a newly allocated chunk.
+      */
+     explicit Arena(size_t chunkSize = 1 << 20);
+
+     /**
+      * @brief Allocates uninitialized memory from the arena.
+      * @param bytes Number of bytes.
+      * @param align Required alignment (a power of two).
+      * @return Pointer to the memory, valid until the enclosing mark is released.
+      */
+     void *allocate(size_t bytes, size_t align);
+
+     /**
+      * @brief Returns the current position of the arena.
+      */
+     Mark mark() const;
+
+     /**
+      * @brief Releases everything allocated after the given mark.
+      * @param m A mark previously returned by mark().
+      */
+     void release(const Mark &m);
+
+     /**
+      * @brief Total number of bytes handed out by this arena.
+      */
+     long long bytesAllocated() const;
+
+ private:
+     struct Chunk {
+         std::unique_ptr<char[]> data;  ///< Chunk storage.
+         size_t size;                   ///< Chunk size in bytes.
+     };
+     std::vector<Chunk> chunks;
+     size_t current;      ///< Index of the chunk being filled.
+     size_t offset;       ///< Fill level of the current chunk.
+     size_t chunkSize;    ///< Default chunk size.
+     long long allocated; ///< Bytes handed out so far.
+ };
+
+ /**
+  * @brief Returns the arena of the calling thread.
+  */
+ Arena &threadArena();
+
+ /**
+  * @brief RAII scope that releases the arena to its state at construction.
+  */
+ class ArenaScope {
+ public:
+     /**
+      * @brief Opens a scope on the given arena.
+      * @param a The arena.
+      */
+     explicit ArenaScope(Arena &a) : arena(a), start(a.mark()) {}
+     ~ArenaScope() { arena.release(start); }
+     ArenaScope(const ArenaScope &) = delete;
+     ArenaScope &operator=(const ArenaScope &) = delete;
+
+ private:
+     Arena &arena;
+     Arena::Mark start;
+ };
+
+ /**
+  * @brief STL allocator drawing from an arena; deallocation is a no-op.
+  * @tparam T Value type.
+  */
+ template <typename T>
+ struct ArenaAllocator {
+     using value_type = T;
+
+     Arena *arena;  ///< The arena memory is drawn from.
+
+     /**
+      * @brief Constructs an allocator for the calling thread's arena.
+      */
+     ArenaAllocator() : arena(&threadArena()) {}
+
+     /**
+      * @brief Constructs an allocator for the given arena.
+      * @param a The arena.
+      */
+     explicit ArenaAllocator(Arena &a) : arena(&a) {}
+
+     /**
+      * @brief Rebinding constructor.
+      */
+     template <typename U>
+     ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.arena) {}
+
+     T *allocate(size_t count) {
+         return static_cast<T *>(arena->allocate(count * sizeof(T), alignof(T)));
+     }
+     void deallocate(T *, size_t) {}
+
+     template <typename U>
+     bool operator==(const ArenaAllocator<U> &other) const { return arena == other.arena; }
+     template <typename U>
+     bool operator!=(const ArenaAllocator<U> &other) const { return arena != other.arena; }
+ };
+
+ /**
+  * @brief A vector whose storage lives in the calling thread's arena.
+  */
+ template <typename T>
+ using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+ #endif // ARENA_HPP
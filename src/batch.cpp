@@ -0,0 +1,270 @@
+/**
+ * @file batch.cpp
+ * @brief Implementation of the batch mode.
+ */
+
+ #include "batch.hpp"
+ #include <mpi.h>
+ #include <omp.h>
+ #include <algorithm>
+ #include <chrono>
+ #include <deque>
+ #include <fstream>
+ #include <iostream>
+ #include <mutex>
+ #include <sstream>
+ #include <thread>
+ #include <vector>
+
+ namespace {
+
+ /**
+  * @brief One graph of the batch: a file to read, or a graph parsed from the stream.
+  */
+ struct BatchItem {
+     std::string name;  ///< Name in the output (file base name, or stream base name and index).
+     std::string path;  ///< File of the graph (empty for stream items).
+     Graph graph;       ///< The graph (stream items only).
+ };
+
+ /**
+  * @brief Base name of a path (without directory or extension).
+  */
+ std::string baseName(const std::string &path) {
+     size_t slash = path.find_last_of("/\\");
+     std::string base = (slash == std::string::npos) ? path : path.substr(slash + 1);
+     size_t dot = base.find_last_of('.');
+     return (dot == std::string::npos) ? base : base.substr(0, dot);
+ }
+
+ /**
+  * @brief Reads the items of a batch file (a list of paths or a stream of .col graphs).
+  * @return False if the file cannot be opened.
+  */
+ bool readBatch(const std::string &batchFile, std::vector<BatchItem> &items) {
+     std::ifstream in(batchFile);
+     if (!in) return false;
+     size_t slash = batchFile.find_last_of("/\\");
+     std::string dir = (slash == std::string::npos) ? "" : batchFile.substr(0, slash + 1);
+
+     int n = -1;
+     std::vector<std::pair<int, int>> edges;
+     auto finishGraph = [&]() {
+         if (n < 0) return;
+         items.push_back({baseName(batchFile) + "#" + std::to_string(items.size()), "", Graph::fromEdges(n, edges)});
+         edges.clear();
+     };
+     std::string line;
+     while (std::getline(in, line)) {
+         if (line.empty() || (line[0] == 'c' && (line.size() == 1 || line[1] == ' '))) continue;
+         std::istringstream iss(line);
+         if (line[0] == 'p' && line.size() > 1 && line[1] == ' ') {
+             finishGraph();
+             std::string tmp;
+             long long m = 0;
+             iss >> tmp >> tmp >> n >> m;
+             edges.reserve(m);
+         } else if (line[0] == 'e' && line.size() > 1 && line[1] == ' ' && n >= 0) {
+             char e;
+             int u, v;
+             iss >> e >> u >> v;
+             edges.emplace_back(u - 1, v - 1);
+         } else if (n < 0) {
+             std::string path;
+             iss >> path;
+             if (path.empty()) continue;
+             if (path[0] != '/' && !std::ifstream(path))
+                 path = dir + path;
+             items.push_back({baseName(path), path, Graph()});
+         }
+     }
+     finishGraph();
+     return true;
+ }
+
+ /**
+  * @brief Batch index counter shared by all processes (an MPI window on the root).
+  *
+  * MPI is called under the mpi critical section, as MPI_THREAD_SERIALIZED requires.
+  * Without that level only the master thread may call MPI (as for the stop signal): it
+  * claims one index per thread of the team into a local pool, from which the other
+  * threads take theirs, waiting for the master to refill it when it runs dry.
+  */
+ class SharedCounter {
+ public:
+     /**
+      * @param limit_ Number of items; indices from limit_ on mean the batch is done.
+      */
+     explicit SharedCounter(long long limit_) : limit(limit_) {
+         int rank, threadLevel;
+         MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+         MPI_Query_thread(&threadLevel);
+         anyThread = threadLevel >= MPI_THREAD_SERIALIZED;
+         MPI_Win_allocate(rank == 0 ? sizeof(long long) : 0, sizeof(long long), MPI_INFO_NULL,
+                          MPI_COMM_WORLD, &value, &window);
+         if (rank == 0) *value = 0;
+         MPI_Barrier(MPI_COMM_WORLD);
+     }
+     ~SharedCounter() { MPI_Win_free(&window); }
+
+     /** @brief Returns the counter and increments it (call from inside the parallel region). */
+     long long next() {
+         if (anyThread) return fetch();
+         const bool master = omp_get_thread_num() == 0;
+         while (true) {
+             {
+                 // The master refills and takes its index under one lock, so it never waits.
+                 std::lock_guard<std::mutex> lock(poolMutex);
+                 while (master && !exhausted && static_cast<int>(pool.size()) < omp_get_num_threads()) {
+                     pool.push_back(fetch());
+                     exhausted = pool.back() >= limit;
+                 }
+                 if (!pool.empty()) {
+                     long long result = pool.front();
+                     pool.pop_front();
+                     return result;
+                 }
+                 if (exhausted) return limit;
+             }
+             std::this_thread::sleep_for(std::chrono::microseconds(100));
+         }
+     }
+
+ private:
+     /** @brief Claims the next index from the window. */
+     long long fetch() {
+         const long long one = 1;
+         long long result;
+         #pragma omp critical(mpi)
+         {
+             MPI_Win_lock(MPI_LOCK_SHARED, 0, 0, window);
+             MPI_Fetch_and_op(&one, &result, MPI_LONG_LONG, 0, 0, MPI_SUM, window);
+             MPI_Win_unlock(0, window);
+         }
+         return result;
+     }
+
+     long long limit;
+     bool anyThread;                // MPI may be called from any thread (one at a time).
+     long long *value;
+     MPI_Win window;
+     std::mutex poolMutex;          // Guards pool and exhausted (funneled mode only).
+     std::deque<long long> pool;    // Indices claimed by the master thread, in claim order.
+     bool exhausted = false;        // The master claimed an index from limit on.
+ };
+
+ } // namespace
+
+ /**
+  * @brief Solves every graph of a batch file and writes one record per graph.
+  * @param batchFile The list or stream of graphs.
+  * @param outputFileName Output file written by the root process.
+  * @param options Options of each solve (timeLimit is per graph).
+  * @param cmdLine Command line, copied to the output.
+  * @return 0 on success, 1 if the batch or output file cannot be opened.
+  */
+ int runBatch(const std::string &batchFile, const std::string &outputFileName,
+              const SolveOptions &options, const std::string &cmdLine) {
+     auto started = std::chrono::steady_clock::now();
+     int mpiRank, mpiSize;
+     MPI_Comm_rank(MPI_COMM_WORLD, &mpiRank);
+     MPI_Comm_size(MPI_COMM_WORLD, &mpiSize);
+
+     std::vector<BatchItem> items;
+     if (!readBatch(batchFile, items)) {
+         if (mpiRank == 0)
+             std::cerr << "Error opening batch file " << batchFile << std::endl;
+         return 1;
+     }
+     const long long numItems = static_cast<long long>(items.size());
+
+     // Every thread of every process solves the next unclaimed graph on its own.
+     SolveOptions single = options;
+     single.numThreads = 1;
+     std::vector<std::pair<long long, std::string>> records;  // (batch index, record line)
+     long long localNodes = 0;
+     int localOptimal = 0;
+     {
+         SharedCounter counter(numItems);
+         #pragma omp parallel reduction(+:localNodes, localOptimal)
+         {
+             std::vector<std::pair<long long, std::string>> threadRecords;
+             for (long long i = counter.next(); i < numItems; i = counter.next()) {
+                 const BatchItem &item = items[i];
+                 std::ostringstream record;
+                 record << item.name << " ";
+                 if (!item.path.empty() && !std::ifstream(item.path)) {
+                     record << "error: cannot open " << item.path;
+                 } else {
+                     SolveResult r = item.path.empty() ? solveColoring(item.graph, single)
+                                                       : solveColoring(readGraphFromCOLFile(item.path), single);
+                     record << r.numColors << " " << r.lowerBound << " " << (r.optimal ? "true" : "false")
+                            << " " << r.nodes << " " << r.seconds;
+                     for (int c : r.coloring)
+                         record << " " << c;
+                     localNodes += r.nodes;
+                     localOptimal += r.optimal ? 1 : 0;
+                 }
+                 threadRecords.emplace_back(i, record.str());
+             }
+             #pragma omp critical(batchRecords)
+             records.insert(records.end(), std::make_move_iterator(threadRecords.begin()),
+                            std::make_move_iterator(threadRecords.end()));
+         }
+         MPI_Barrier(MPI_COMM_WORLD);  // The window is freed only once every process is done.
+     }
+
+     // Gather the records on the root process as "index record" lines.
+     std::string local;
+     for (const auto &r : records)
+         local += std::to_string(r.first) + " " + r.second + "\n";
+     int localSize = static_cast<int>(local.size());
+     std::vector<int> sizes(mpiSize, 0), displs(mpiSize, 0);
+     MPI_Gather(&localSize, 1, MPI_INT, sizes.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+     std::string all;
+     if (mpiRank == 0) {
+         for (int r = 1; r < mpiSize; r++)
+             displs[r] = displs[r - 1] + sizes[r - 1];
+         all.resize(displs[mpiSize - 1] + sizes[mpiSize - 1]);
+     }
+     MPI_Gatherv(local.data(), localSize, MPI_CHAR, &all[0], sizes.data(), displs.data(), MPI_CHAR, 0, MPI_COMM_WORLD);
+     long long totalNodes = 0;
+     int totalOptimal = 0;
+     MPI_Reduce(&localNodes, &totalNodes, 1, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+     MPI_Reduce(&localOptimal, &totalOptimal, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+     if (mpiRank != 0) return 0;
+
+     std::vector<std::string> ordered(items.size());
+     std::istringstream gathered(all);
+     std::string line;
+     while (std::getline(gathered, line)) {
+         size_t space = line.find(' ');
+         ordered[std::stoll(line.substr(0, space))] = line.substr(space + 1);
+     }
+     double wallTime = std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - started).count();
+
+     std::ofstream outFile(outputFileName);
+     if (!outFile) {
+         std::cerr << "Error opening output file " << outputFileName << std::endl;
+         return 1;
+     }
+     outFile << "problem_batch_file_name: " << baseName(batchFile) << "\n";
+     outFile << "cmd_line: " << cmdLine << "\n";
+     outFile << "solver_version: v1.0.0\n";
+     outFile << "number_of_graphs: " << numItems << "\n";
+     outFile << "time_limit_per_graph_sec: " << options.timeLimit << "\n";
+     outFile << "number_of_mpi_processes: " << mpiSize << "\n";
+     outFile << "number_of_threads_per_process: " << omp_get_max_threads() << "\n";
+     outFile << "wall_time_sec: " << wallTime << "\n";
+     outFile << "graphs_per_sec: " << (wallTime > 0 ? numItems / wallTime : 0) << "\n";
+     outFile << "number_of_optimal_graphs: " << totalOptimal << "\n";
+     outFile << "number_of_nodes: " << totalNodes << "\n";
+     outFile << "# graph colors lower_bound optimal nodes time_sec coloring\n";
+     for (const std::string &record : ordered)
+         outFile << record << "\n";
+     outFile.close();
+     std::cout << "Solved " << numItems << " graphs in " << wallTime << " s ("
+               << (wallTime > 0 ? numItems / wallTime : 0) << " graphs/s); output written to "
+               << outputFileName << std::endl;
+     return 0;
+ }
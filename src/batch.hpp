@@ -0,0 +1,34 @@
+/**
+ * @file batch.hpp
+ * @brief Declaration of the batch mode: many small graphs solved in one run.
+ *
+ * The batch file is either a list of .col paths (one per line; relative paths are
+ * resolved against the directory of the list) or a concatenated stream of .col graphs,
+ * each starting at its "p edge" line. Every graph is solved independently with
+ * solveColoring() on one thread; the OpenMP threads of all MPI processes claim the next
+ * graph from a shared counter, so long and short graphs balance dynamically.
+ */
+
+ #ifndef BATCH_HPP
+ #define BATCH_HPP
+
+ #include "coloring.hpp"
+ #include <string>
+
+ /**
+  * @brief Solves every graph of a batch file and writes one record per graph.
+  *
+  * Collective over MPI_COMM_WORLD. The root process writes the output file: a header
+  * with the totals and the throughput (graphs per second), then one line per graph in
+  * batch order: name, colors, lower bound, optimality, nodes, seconds and the coloring.
+  *
+  * @param batchFile The list or stream of graphs.
+  * @param outputFileName Output file written by the root process.
+  * @param options Options of each solve (timeLimit is per graph).
+  * @param cmdLine Command line, copied to the output.
+  * @return 0 on success, 1 if the batch or output file cannot be opened.
+  */
+ int runBatch(const std::string &batchFile, const std::string &outputFileName,
+              const SolveOptions &options, const std::string &cmdLine);
+
+ #endif // BATCH_HPP
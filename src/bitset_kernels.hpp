@@ -0,0 +1,318 @@
+/**
+ * @file bitset_kernels.hpp
+ * @brief Fixed-width bitset kernels for the clique, DSATUR and branching routines.
+ *
+ * The kernels are templated on the number of 64-bit words per adjacency row, so for
+ * small graphs a row fits in a few registers and every loop over it is unrolled.
+ * dispatchByWidth() selects the smallest instantiation that fits the current number
+ * of vertices; since it is called on every node, the search re-dispatches to narrower
+ * kernels as merges shrink the graph. A search node builds its matrix once as a
+ * NodeBitGraph and hands it to every kernel it runs.
+ */
+
+ #ifndef BITSET_KERNELS_HPP
+ #define BITSET_KERNELS_HPP
+
+ #include "arena.hpp"
+ #include "graph.hpp"
+ #include "simd_kernels.hpp"
+ #include <algorithm>
+ #include <cstdint>
+ #include <type_traits>
+ #include <utility>
+ #include <variant>
+ #include <vector>
+
+ /**
+  * @brief Largest number of vertices handled by the fixed-width kernels.
+  */
+ const int MAX_BITSET_VERTICES = 1024;
+ 
+ /**
+  * @brief Smallest row width (in words) for which the runtime-dispatched SIMD kernels are used.
+  *
+  * Narrower rows stay in registers with inline scalar code, where an indirect call
+  * would cost more than the work.
+  */
+ const int SIMD_MIN_WORDS = 8;
+
+ /**
+  * @brief A bitset of W 64-bit words.
+  * @tparam W Number of words.
+  */
+ template <int W>
+ struct FixedBitset {
+     uint64_t w[W];  ///< Words, bit i of the set is bit (i % 64) of w[i / 64].
+
+     void clear() { for (int k = 0; k < W; k++) w[k] = 0; }
+     void set(int i) { w[i >> 6] |= uint64_t(1) << (i & 63); }
+     void reset(int i) { w[i >> 6] &= ~(uint64_t(1) << (i & 63)); }
+     bool test(int i) const { return (w[i >> 6] >> (i & 63)) & 1; }
+
+     bool any() const {
+         uint64_t acc = 0;
+         for (int k = 0; k < W; k++) acc |= w[k];
+         return acc != 0;
+     }
+     int count() const {
+         if constexpr (W >= SIMD_MIN_WORDS) return bitsetPopcount(w, W);
+         int c = 0;
+         for (int k = 0; k < W; k++) c += __builtin_popcountll(w[k]);
+         return c;
+     }
+     /** @brief Sets the first n bits and clears the rest. */
+     void fillFirst(int n) {
+         for (int k = 0; k < W; k++) {
+             int lo = k * 64;
+             w[k] = (n >= lo + 64) ? ~uint64_t(0) : (n <= lo ? 0 : (uint64_t(1) << (n - lo)) - 1);
+         }
+     }
+     /** @brief Index of the lowest set bit, or -1 if empty. */
+     int first() const {
+         for (int k = 0; k < W; k++)
+             if (w[k]) return k * 64 + __builtin_ctzll(w[k]);
+         return -1;
+     }
+     /** @brief Index of the lowest clear bit (the set must not be full). */
+     int firstClear() const {
+         for (int k = 0; k < W; k++)
+             if (~w[k]) return k * 64 + __builtin_ctzll(~w[k]);
+         return W * 64;
+     }
+     /** @brief |this ∩ other|. */
+     int andCount(const FixedBitset &o) const {
+         if constexpr (W >= SIMD_MIN_WORDS) return bitsetAndCount(w, o.w, W);
+         int c = 0;
+         for (int k = 0; k < W; k++) c += __builtin_popcountll(w[k] & o.w[k]);
+         return c;
+     }
+     FixedBitset operator&(const FixedBitset &o) const {
+         FixedBitset r;
+         if constexpr (W >= SIMD_MIN_WORDS) bitsetAnd(r.w, w, o.w, W);
+         else for (int k = 0; k < W; k++) r.w[k] = w[k] & o.w[k];
+         return r;
+     }
+     FixedBitset operator|(const FixedBitset &o) const {
+         FixedBitset r;
+         for (int k = 0; k < W; k++) r.w[k] = w[k] | o.w[k];
+         return r;
+     }
+     /** @brief this \ other. */
+     FixedBitset andNot(const FixedBitset &o) const {
+         FixedBitset r;
+         if constexpr (W >= SIMD_MIN_WORDS) bitsetAndNot(r.w, w, o.w, W);
+         else for (int k = 0; k < W; k++) r.w[k] = w[k] & ~o.w[k];
+         return r;
+     }
+
+     /**
+      * @brief Calls f(i) for every set bit i in increasing order.
+      */
+     template <typename F>
+     void forEach(F &&f) const {
+         for (int k = 0; k < W; k++)
+             for (uint64_t word = w[k]; word; word &= word - 1)
+                 f(k * 64 + __builtin_ctzll(word));
+     }
+ };
+
+ /**
+  * @brief Adjacency matrix of a graph as fixed-width bitset rows (in the thread arena).
+  * @tparam W Number of words per row.
+  */
+ template <int W>
+ struct BitGraph {
+     int n;                              ///< Number of vertices.
+     ArenaVector<FixedBitset<W>> rows;   ///< rows[v] is the neighborhood of v.
+
+     /**
+      * @brief Builds the bitset rows from the adjacency lists of a graph.
+      * @param g A graph with at most 64 * W vertices.
+      */
+     explicit BitGraph(const Graph &g) : n(g.n), rows(g.n) {
+         for (int v = 0; v < n; v++) {
+             rows[v].clear();
+             for (int u : g.neighbors(v))
+                 rows[v].set(u);
+         }
+     }
+ };
+
+ /**
+  * @brief Calls f(std::integral_constant<int, W>) with the smallest supported W >= ceil(n / 64).
+  *
+  * @param n Number of vertices.
+  * @param f Generic callable taking the word count as an integral constant.
+  * @return False (without calling f) if n exceeds MAX_BITSET_VERTICES.
+  */
+ template <typename F>
+ bool dispatchByWidth(int n, F &&f) {
+     if (n <= 64)   { f(std::integral_constant<int, 1>{});  return true; }
+     if (n <= 128)  { f(std::integral_constant<int, 2>{});  return true; }
+     if (n <= 256)  { f(std::integral_constant<int, 4>{});  return true; }
+     if (n <= 512)  { f(std::integral_constant<int, 8>{});  return true; }
+     if (n <= 1024) { f(std::integral_constant<int, 16>{}); return true; }
+     return false;
+ }
+
+ /**
+  * @brief The bitset adjacency matrix of a search node, built once and shared by its kernels.
+  *
+  * The width is dispatched once, when the matrix is built; graphs above
+  * MAX_BITSET_VERTICES vertices get no matrix and the callers fall back to the
+  * adjacency-list routines. The rows live in the thread arena, so the object must not
+  * outlive the ArenaScope it was built in.
+  */
+ struct NodeBitGraph {
+     std::variant<std::monostate, BitGraph<1>, BitGraph<2>, BitGraph<4>, BitGraph<8>, BitGraph<16>> bits;
+
+     /**
+      * @brief Builds the matrix of g if g has at most MAX_BITSET_VERTICES vertices.
+      * @param g The node graph.
+      */
+     explicit NodeBitGraph(const Graph &g) {
+         dispatchByWidth(g.n, [&](auto width) {
+             bits.template emplace<BitGraph<decltype(width)::value>>(g);
+         });
+     }
+
+     /**
+      * @brief Calls f(bitGraph) on the matrix.
+      * @return False (without calling f) if the graph has no matrix.
+      */
+     template <typename F>
+     bool apply(F &&f) const {
+         if (std::holds_alternative<std::monostate>(bits))
+             return false;
+         std::visit([&](const auto &bg) {
+             if constexpr (!std::is_same_v<std::decay_t<decltype(bg)>, std::monostate>)
+                 f(bg);
+         }, bits);
+         return true;
+     }
+ };
+
+ /**
+  * @brief Bron–Kerbosch with pivoting on bitsets, pruned by |R| + |P| <= best.
+  */
+ template <int W>
+ void bitBronKerbosch(const BitGraph<W> &g, ArenaVector<int> &R, FixedBitset<W> P, FixedBitset<W> X,
+                      std::vector<int> &bestClique) {
+     if (!P.any()) {
+         if (!X.any() && R.size() > bestClique.size())
+             bestClique.assign(R.begin(), R.end());
+         return;
+     }
+     if (R.size() + P.count() <= bestClique.size())
+         return;
+     // Choose a pivot u from P ∪ X that maximizes |P ∩ N(u)|.
+     int pivot = -1, maxCount = -1;
+     auto considerPivot = [&](int u) {
+         int c = P.andCount(g.rows[u]);
+         if (c > maxCount) { maxCount = c; pivot = u; }
+     };
+     P.forEach(considerPivot);
+     X.forEach(considerPivot);
+     FixedBitset<W> candidates = P.andNot(g.rows[pivot]);
+     candidates.forEach([&](int v) {
+         R.push_back(v);
+         bitBronKerbosch(g, R, P & g.rows[v], X & g.rows[v], bestClique);
+         R.pop_back();
+         P.reset(v);
+         X.set(v);
+     });
+ }
+
+ /**
+  * @brief Maximum clique on a fixed-width bitset graph.
+  * @param g The graph.
+  * @return The vertices of a maximum clique.
+  */
+ template <int W>
+ std::vector<int> bitMaxClique(const BitGraph<W> &g) {
+     ArenaVector<int> R;
+     R.reserve(g.n);
+     FixedBitset<W> P, X;
+     P.fillFirst(g.n);
+     X.clear();
+     std::vector<int> bestClique;
+     bitBronKerbosch(g, R, P, X, bestClique);
+     return bestClique;
+ }
+
+ /**
+  * @brief DSATUR on a fixed-width bitset graph.
+  *
+  * Saturation sets are kept as bitsets over the colors, so the saturation of a vertex
+  * is a popcount and its smallest free color is the lowest clear bit. Ties are broken
+  * by degree, then by lowest index.
+  *
+  * @param g The graph.
+  * @param color Output: color of each vertex.
+  * @return The number of colors used.
+  */
+ template <int W>
+ int bitDsatur(const BitGraph<W> &g, std::vector<int> &color) {
+     int n = g.n;
+     color.assign(n, -1);
+     ArenaVector<FixedBitset<W>> satSet(n);
+     ArenaVector<int> degree(n);
+     for (int v = 0; v < n; v++) {
+         satSet[v].clear();
+         degree[v] = g.rows[v].count();
+     }
+     FixedBitset<W> uncolored;
+     uncolored.fillFirst(n);
+     int usedColors = 0;
+     for (int step = 0; step < n; step++) {
+         int bestV = -1, bestSat = -1, bestDeg = -1;
+         uncolored.forEach([&](int v) {
+             int sat = satSet[v].count();
+             if (sat > bestSat || (sat == bestSat && degree[v] > bestDeg)) {
+                 bestV = v;
+                 bestSat = sat;
+                 bestDeg = degree[v];
+             }
+         });
+         int c = satSet[bestV].firstClear();
+         color[bestV] = c;
+         usedColors = std::max(usedColors, c + 1);
+         uncolored.reset(bestV);
+         (g.rows[bestV] & uncolored).forEach([&](int w) { satSet[w].set(c); });
+     }
+     return usedColors;
+ }
+
+ /**
+  * @brief Nonadjacent pair with the largest degree sum on a fixed-width bitset graph.
+  *
+  * Pairs are scanned in the same (i, j) order as the generic routine.
+  *
+  * @param g The graph.
+  * @return The pair, or (-1, -1) if the graph is complete.
+  */
+ template <int W>
+ std::pair<int, int> bitBranchingPair(const BitGraph<W> &g) {
+     ArenaVector<int> degree(g.n);
+     for (int v = 0; v < g.n; v++)
+         degree[v] = g.rows[v].count();
+     FixedBitset<W> all;
+     all.fillFirst(g.n);
+     int v1 = -1, v2 = -1, bestScore = -1;
+     for (int i = 0; i < g.n; i++) {
+         FixedBitset<W> later;
+         later.fillFirst(i + 1);
+         FixedBitset<W> nonNeighbors = all.andNot(g.rows[i]).andNot(later);
+         nonNeighbors.forEach([&](int j) {
+             int score = degree[i] + degree[j];
+             if (score > bestScore) {
+                 bestScore = score;
+                 v1 = i;
+                 v2 = j;
+             }
+         });
+     }
+     return {v1, v2};
+ }
+
+ #endif // BITSET_KERNELS_HPP
@@ -4,16 +4,20 @@
  */
 
  #include "branch_and_bound.hpp"
- #include "globals.hpp"
+ #include "arena.hpp"
+ #include "bitset_kernels.hpp"
+ #include "lower_bounds.hpp"
+ #include "perf_counters.hpp"
+ #include "trace.hpp"
  
- #include <mpi.h>
  #include <omp.h>
- #include <chrono>
  #include <cstdlib>
  #include <iostream>
+ #include <optional>
  #include <sstream>
  #include <algorithm>
  #include <thread>
+ #include <utility>
  
  // Tuning parameters.
  static const int MIN_VERTICES_FOR_TASK = 30;  ///< Minimum vertices to spawn OpenMP tasks.
@@ -24,98 +28,223 @@
   * @brief Selects a branching pair (two nonadjacent vertices with a high degree sum).
   *
   * Searches the graph for two vertices that are not adjacent and whose combined degree is maximal.
+  * Graphs with at most MAX_BITSET_VERTICES vertices use the fixed-width bitset kernel.
+  * Larger graphs avoid the quadratic pair scan: the best score is found by visiting the
+  * vertices in decreasing degree order (the first nonadjacent vertex in that order is the
+  * best partner of a vertex), then the first pair (i < j) with that score is located
+  * through the degree buckets of the same order. Both steps cost O(m log n) and pick the
+  * same pair as the quadratic scan.
   *
   * @param g The graph.
+  * @param bits The bitset matrix of g, built here if null.
   * @return A pair of vertex indices (v1, v2) chosen for branching.
   */
- std::pair<int,int> selectBranchingPair(const Graph &g) {
-     int v1 = -1, v2 = -1, bestScore = -1;
-     std::vector<int> degrees(g.n);
-     for (int i = 0; i < g.n; i++)
-         degrees[i] = g.adj[i].size();
-     for (int i = 0; i < g.n; i++) {
-         for (int j = i + 1; j < g.n; j++) {
-             if (g.adj[i].find(j) == g.adj[i].end()) {
-                 int score = degrees[i] + degrees[j];
-                 if (score > bestScore) {
-                     bestScore = score;
-                     v1 = i;
-                     v2 = j;
-                 }
-             }
+ std::pair<int,int> selectBranchingPair(const Graph &g, const NodeBitGraph *bits) {
+     PerfRegion region(PerfPhase::Branching);
+     ArenaScope scope(threadArena());
+     std::optional<NodeBitGraph> ownBits;
+     if (!bits)
+         bits = &ownBits.emplace(g);
+     std::pair<int,int> bitPair;
+     if (bits->apply([&](const auto &bg) { bitPair = bitBranchingPair(bg); }))
+         return bitPair;
+ 
+     // Vertices by decreasing degree, ties by increasing index.
+     ArenaVector<int> byDegree(g.n);
+     for (int v = 0; v < g.n; v++)
+         byDegree[v] = v;
+     std::stable_sort(byDegree.begin(), byDegree.end(),
+                      [&](int a, int b) { return g.degree(a) > g.degree(b); });
+ 
+     int bestScore = -1;
+     for (int u : byDegree) {
+         if (g.degree(u) + g.degree(byDegree[0]) <= bestScore)
+             break;
+         for (int w : byDegree) {
+             if (w == u || g.hasEdge(u, w))
+                 continue;
+             bestScore = std::max(bestScore, g.degree(u) + g.degree(w));
+             break;
          }
      }
-     return {v1, v2};
+     if (bestScore < 0)
+         return {-1, -1};
+ 
+     for (int i = 0; i < g.n; i++) {
+         int d = bestScore - g.degree(i);
+         auto bucketBegin = std::lower_bound(byDegree.begin(), byDegree.end(), d,
+                                             [&](int v, int deg) { return g.degree(v) > deg; });
+         auto bucketEnd = std::upper_bound(bucketBegin, byDegree.end(), d,
+                                           [&](int deg, int v) { return deg > g.degree(v); });
+         for (auto it = std::upper_bound(bucketBegin, bucketEnd, i); it != bucketEnd; ++it)
+             if (!g.hasEdge(i, *it))
+                 return {i, *it};
+     }
+     return {-1, -1};
  }
  
  /**
-  * @brief Recursive branch-and-bound function for graph coloring.
-  *
-  * Explores the search space recursively using both merging and edge addition
-  * strategies and updates the best solution.
+  * @brief The incumbent a node is pruned against: the own one, or the fewer colors found
+  *        by the other processes of a shared search.
+  */
+ static int sharedIncumbent(const ColoringSolution &bestSolution, const SearchContext &ctx) {
+     int shared = ctx.sharedColors.load(std::memory_order_relaxed);
+     return shared > 0 ? std::min(bestSolution.numColors, shared) : bestSolution.numColors;
+ }
+ 
+ /**
+  * @brief Evaluates one search node: bounds, incumbent update, pruning and branching pair.
   *
-  * @param g The current graph.
-  * @param bestSolution The best coloring solution found so far.
-  * @param timeLimit Time limit for the search (in seconds).
-  * @param depth Current recursion depth.
+  * @param g The node graph.
+  * @param bestSolution The best coloring solution found so far (updated).
+  * @param ctx The search context (time limit, settings, statistics).
+  * @param depth Depth of the node.
+  * @return The evaluation; the node is branched on only if expand is true.
   */
- void branchAndBound(const Graph &g, ColoringSolution &bestSolution, double timeLimit, int depth) {
-     if (std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - startTime).count() >= timeLimit) {
-         searchCompleted = false;
-         return;
+ NodeEvaluation evaluateNode(const Graph &g, ColoringSolution &bestSolution, SearchContext &ctx, int depth) {
+     NodeEvaluation result{false, 0, -1, -1};
+     if (ctx.timeUp()) {
+         ctx.completed = false;
+         return result;
      }
-     // Compute lower (clique) and upper (DSATUR) bounds.
-     auto [lb, clique] = g.heuristicMaxClique();
-     auto [ub, coloring] = g.heuristicColoring();
+     long long explored = ++ctx.nodesExplored;
+     PerfRegion region(PerfPhase::Node);
  
-     // Log the current branch-and-bound node.
+     // An external stop request (e.g. from another process in decision mode) ends the search.
+     if (ctx.stopRequested && ctx.stopRequested(explored)) return result;
+ 
+     // Stop as soon as the incumbent meets the global lower bound.
+     int incumbent;
+     #pragma omp critical
+     incumbent = sharedIncumbent(bestSolution, ctx);
+     if (incumbent <= ctx.colorTarget.load(std::memory_order_relaxed)) return result;
+     // Per-node scratch data comes from the thread arena; account for it per node.
+     Arena &arena = threadArena();
+     long long arenaBefore = arena.bytesAllocated();
+     ArenaScope scope(arena);
+ 
+     // The bitset matrix is built once and shared by DSATUR, the clique bound and the
+     // branching pair.
+     NodeBitGraph bits(g);
+ 
+     // Compute the upper (DSATUR) bound.
+     auto [ub, coloring] = g.heuristicColoring(&bits);
+ 
+     // Update best solution (critical section). The coloring of the original vertices
+     // is only expanded when it improves the incumbent seen at the start of the node.
+     // The incumbent is re-read in the critical section so the pruning tests below never
+     // see a torn update.
+     vector<int> expanded;
+     if (ub < incumbent)
+         expanded = g.expandColoring(coloring);
+     #pragma omp critical
      {
-         double currentTime = std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - startTime).count();
+         if (ub < bestSolution.numColors && !expanded.empty()) {
+             bestSolution.numColors = ub;
+             bestSolution.coloring = std::move(expanded);
+             ctx.incumbentColors = ub;
+             traceCounter("incumbent", ub);
+         }
+         incumbent = sharedIncumbent(bestSolution, ctx);
+     }
+     if (ctx.decisionColors > 0 && incumbent <= ctx.decisionColors && ctx.onDecided)
+         ctx.onDecided();
+     if (incumbent <= ctx.colorTarget.load(std::memory_order_relaxed)) {
+         ctx.arenaBytes += arena.bytesAllocated() - arenaBefore;
+         return result;
+     }
+ 
+     // Run the lower-bound pipeline (cheapest bounds first) against the incumbent. Since
+     // the incumbent never exceeds ub, this also closes nodes whose bound meets ub.
+     BoundContext bounds(g, depth, incumbent, coloring, ctx.lpBoundDepth);
+     bounds.bits = &bits;
+     int pruningBound = evaluateLowerBounds(bounds);
+     result.lowerBound = bounds.lowerBound;
+ 
+     // Log the current branch-and-bound node.
+     if (ctx.log) {
+         double currentTime = ctx.elapsed();
+         std::ostream &log = *ctx.log;
          #pragma omp critical(log)
          {
-             logStream << "Time: " << currentTime << " sec, Depth: " << depth
-                       << ", Lower bound: " << lb << ", Clique: [";
-             for (int v : clique)
-                 logStream << v << " ";
-             logStream << "], Upper bound: " << ub << ", Coloring: [";
+             log << "Time: " << currentTime << " sec, Depth: " << depth
+                 << ", Lower bound: " << bounds.lowerBound << ", Clique: [";
+             for (int v : bounds.clique)
+                 log << v << " ";
+             log << "], Upper bound: " << ub << ", Coloring: [";
              for (int c : coloring)
-                 logStream << c << " ";
-             logStream << "]" << std::endl;
+                 log << c << " ";
+             log << "]";
+             if (pruningBound >= 0)
+                 log << ", Pruned by: " << lowerBoundPipeline()[pruningBound].name;
+             log << std::endl;
          }
      }
  
-     // Update best solution (critical section).
-     #pragma omp critical
-     {
-         if (ub < bestSolution.numColors) {
-             bestSolution.numColors = ub;
-             bestSolution.coloring.assign(g.orig_n, -1);
-             for (int i = 0; i < g.n; i++) {
-                 for (int orig : g.mapping[i])
-                     bestSolution.coloring[orig] = coloring[i];
-             }
-         }
+     if (pruningBound >= 0) {
+         ctx.boundPrunes[pruningBound]++;
+         ctx.arenaBytes += arena.bytesAllocated() - arenaBefore;
+         return result;
      }
-     if (lb == ub) return;
-     if (lb >= bestSolution.numColors) return;
  
      // Select two nonadjacent vertices for branching.
-     auto [v1, v2] = selectBranchingPair(g);
-     if (v1 == -1) return;  // Graph is a clique.
+     auto [v1, v2] = selectBranchingPair(g, &bits);
+     ctx.arenaBytes += arena.bytesAllocated() - arenaBefore;
+     if (v1 == -1) return result;  // Graph is a clique.
+     result.expand = true;
+     result.v1 = v1;
+     result.v2 = v2;
+     return result;
+ }
  
-     Graph childMerge = g.mergeVertices(v1, v2);
-     Graph childEdge  = g.addEdge(v1, v2);
+ /**
+  * @brief Recursive branch-and-bound function for graph coloring.
+  *
+  * Explores the search space recursively using both merging and edge addition
+  * strategies and updates the best solution.
+  *
+  * @param g The current graph.
+  * @param bestSolution The best coloring solution found so far.
+  * @param ctx The search context (time limit, settings, statistics).
+  * @param depth Current recursion depth.
+  */
+ void branchAndBound(const Graph &g, ColoringSolution &bestSolution, SearchContext &ctx, int depth) {
+     NodeEvaluation node = evaluateNode(g, bestSolution, ctx, depth);
+     if (!node.expand) return;
+ 
+     Graph childMerge = g.mergeVertices(node.v1, node.v2);
+     Graph childEdge  = g.addEdge(node.v1, node.v2);
+     MemoryCharge pathCharge(ctx.graphMemory, childMerge.memoryBytes() + childEdge.memoryBytes());
  
-     bool doParallel = (g.n >= MIN_VERTICES_FOR_TASK) && (depth < MAX_TASK_DEPTH);
+     // Deterministic mode never spawns tasks: children are explored in a fixed order. Neither
+     // does a single-thread team, where deferred tasks would only reorder the children, nor
+     // a search close to its memory limit.
+     bool doParallel = !ctx.deterministicMode && (g.n >= MIN_VERTICES_FOR_TASK) && (depth < MAX_TASK_DEPTH) &&
+                       omp_get_num_threads() > 1;
+     if (doParallel && ctx.memoryNearLimit()) {
+         ctx.memoryLimitedNodes++;
+         doParallel = false;
+     }
      if (doParallel) {
-         #pragma omp task shared(bestSolution) firstprivate(childMerge, timeLimit, depth)
-         { branchAndBound(childMerge, bestSolution, timeLimit, depth + 1); }
-         #pragma omp task shared(bestSolution) firstprivate(childEdge, timeLimit, depth)
-         { branchAndBound(childEdge, bestSolution, timeLimit, depth + 1); }
+         // The children outlive their tasks (taskwait below), so the tasks share them
+         // instead of copying them; they stay charged to graphMemory only.
+         ctx.openTasks += 2;
+         #pragma omp task shared(bestSolution, ctx, childMerge) firstprivate(depth)
+         {
+             TraceSpan span("merge_task", "depth", depth + 1);
+             branchAndBound(childMerge, bestSolution, ctx, depth + 1);
+             ctx.openTasks--;
+         }
+         #pragma omp task shared(bestSolution, ctx, childEdge) firstprivate(depth)
+         {
+             TraceSpan span("edge_task", "depth", depth + 1);
+             branchAndBound(childEdge, bestSolution, ctx, depth + 1);
+             ctx.openTasks--;
+         }
          #pragma omp taskwait
      } else {
-         branchAndBound(childMerge, bestSolution, timeLimit, depth + 1);
-         branchAndBound(childEdge, bestSolution, timeLimit, depth + 1);
+         branchAndBound(childMerge, bestSolution, ctx, depth + 1);
+         branchAndBound(childEdge, bestSolution, ctx, depth + 1);
      }
  }
  
@@ -123,35 +252,85 @@
   * @brief Decomposes the branch-and-bound search tree for MPI distribution.
   *
   * Explores the search tree up to a fixed depth and collects subproblems (tasks)
-  * for distributed processing.
+  * for distributed processing. As in evaluateNode(), the DSATUR coloring of a node
+  * becomes the incumbent when it improves it, so a node closed by its bounds during
+  * the decomposition still contributes its coloring.
   *
   * @param g The current graph.
   * @param depth Current decomposition depth.
   * @param decompDepth Maximum depth for decomposition.
   * @param tasks Vector to store the generated subgraph tasks.
-  * @param timeLimit Time limit for the search (in seconds).
-  * @param dummySolution A dummy solution used for comparison.
+  * @param ctx The search context (time limit, settings).
+  * @param bestSolution The best coloring solution found so far (updated).
   */
  void decomposeBnb(const Graph &g, int depth, int decompDepth,
-                   std::vector<Graph> &tasks, double timeLimit,
-                   const ColoringSolution &dummySolution) {
-     if (std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - startTime).count() >= timeLimit)
+                   std::vector<Graph> &tasks, SearchContext &ctx,
+                   ColoringSolution &bestSolution) {
+     if (ctx.timeUp())
          return;
      if (depth >= decompDepth) {
          tasks.push_back(g);
          return;
      }
-     auto [lb, clique] = g.heuristicMaxClique();
-     auto [ub, coloring] = g.heuristicColoring();
-     if (lb == ub) return;
-     if (lb >= dummySolution.numColors) return;
+     ArenaScope scope(threadArena());
+     NodeBitGraph bits(g);
+     auto [ub, coloring] = g.heuristicColoring(&bits);
+     int incumbent;
+     #pragma omp critical
+     {
+         if (ub < bestSolution.numColors) {
+             bestSolution.numColors = ub;
+             bestSolution.coloring = g.expandColoring(coloring);
+             ctx.incumbentColors = ub;
+             traceCounter("incumbent", ub);
+         }
+         incumbent = bestSolution.numColors;
+     }
+     if (ctx.decisionColors > 0 && incumbent <= ctx.decisionColors && ctx.onDecided)
+         ctx.onDecided();
+     if (incumbent <= ctx.colorTarget.load(std::memory_order_relaxed)) return;
+     BoundContext bounds(g, depth, incumbent, coloring, ctx.lpBoundDepth);
+     bounds.bits = &bits;
+     if (evaluateLowerBounds(bounds) >= 0) return;
  
-     auto [v1, v2] = selectBranchingPair(g);
+     auto [v1, v2] = selectBranchingPair(g, &bits);
      if (v1 == -1) return;
-     Graph childMerge = g.mergeVertices(v1, v2);
-     Graph childEdge  = g.addEdge(v1, v2);
+     Graph children[2] = {g.mergeVertices(v1, v2), g.addEdge(v1, v2)};
  
-     decomposeBnb(childMerge, depth + 1, decompDepth, tasks, timeLimit, dummySolution);
-     decomposeBnb(childEdge, depth + 1, decompDepth, tasks, timeLimit, dummySolution);
+     // Children at the decomposition depth become tasks as they are, without a copy.
+     for (Graph &child : children) {
+         if (depth + 1 < decompDepth)
+             decomposeBnb(child, depth + 1, decompDepth, tasks, ctx, bestSolution);
+         else if (!ctx.timeUp())
+             tasks.push_back(std::move(child));
+     }
+ }
+
+ /**
+  * @brief Rebuilds one subproblem of the search tree split at a fixed depth.
+  *
+  * The bits of index, from the most significant of the splitDepth bits down, choose
+  * the merge (0) or addEdge (1) child at each level. No bounds are evaluated on the
+  * way, so every process that splits the same graph numbers the subproblems alike.
+  * A path that reaches a complete graph above splitDepth ends there: the leaf belongs
+  * to the index whose remaining bits are all 0, and the other indices are empty.
+  *
+  * @param g The root graph.
+  * @param splitDepth Depth of the split (the subproblems are numbered 0 .. 2^splitDepth - 1).
+  * @param index Number of the subproblem.
+  * @param task Output: the subproblem graph.
+  * @return False if the subproblem is empty.
+  */
+ bool subproblemAt(const Graph &g, int splitDepth, long long index, Graph &task) {
+     task = g;
+     for (int level = 0; level < splitDepth; level++) {
+         long long below = index & ((1LL << (splitDepth - level)) - 1);
+         auto [v1, v2] = selectBranchingPair(task);
+         if (v1 == -1)
+             return below == 0;
+         bool edge = (below >> (splitDepth - level - 1)) & 1;
+         task = edge ? task.addEdge(v1, v2) : task.mergeVertices(v1, v2);
+     }
+     return true;
  }
  
\ No newline at end of file
@@ -7,8 +7,33 @@
  #define BRANCH_AND_BOUND_HPP
  
  #include "graph.hpp"
+ #include "search_context.hpp"
  #include <vector>
  
+ /**
+  * @brief Outcome of the evaluation of a search node.
+  */
+ struct NodeEvaluation {
+     bool expand;     ///< True if the node must be branched on.
+     int lowerBound;  ///< Lower bound of the node, also valid for both of its children.
+     int v1;          ///< First vertex of the branching pair (if expand).
+     int v2;          ///< Second vertex of the branching pair (if expand).
+ };
+ 
+ /**
+  * @brief Evaluates one search node without branching.
+  *
+  * Checks the time limit, computes the bounds, updates the best solution and selects
+  * the branching pair. Shared by the recursive search and the node-queue engine.
+  *
+  * @param g The node graph.
+  * @param bestSolution The best coloring solution found so far (updated).
+  * @param ctx The search context (time limit, settings, statistics).
+  * @param depth Depth of the node.
+  * @return The evaluation; the node is branched on only if expand is true.
+  */
+ NodeEvaluation evaluateNode(const Graph &g, ColoringSolution &bestSolution, SearchContext &ctx, int depth);
+ 
  /**
   * @brief Recursive branch-and-bound routine for graph coloring.
   *
@@ -17,10 +42,10 @@
   *
   * @param g The current graph.
   * @param bestSolution The best coloring solution found so far.
-  * @param timeLimit Time limit for the search (in seconds).
+  * @param ctx The search context (time limit, settings, statistics).
   * @param depth Current recursion depth.
   */
- void branchAndBound(const Graph &g, ColoringSolution &bestSolution, double timeLimit, int depth = 0);
+ void branchAndBound(const Graph &g, ColoringSolution &bestSolution, SearchContext &ctx, int depth = 0);
  
  /**
   * @brief Decomposes the branch-and-bound search tree for MPI distribution.
@@ -31,19 +56,35 @@
   * @param depth Current depth of decomposition.
   * @param decompDepth Maximum depth for decomposition.
   * @param tasks Vector to store generated subgraph tasks.
-  * @param timeLimit Time limit for the search (in seconds).
-  * @param dummySolution A dummy solution used for comparisons.
+  * @param ctx The search context (time limit, settings).
+  * @param bestSolution The best coloring solution found so far (updated with the
+  *        colorings of the decomposition nodes).
   */
  void decomposeBnb(const Graph &g, int depth, int decompDepth,
-                   std::vector<Graph> &tasks, double timeLimit,
-                   const ColoringSolution &dummySolution);
+                   std::vector<Graph> &tasks, SearchContext &ctx,
+                   ColoringSolution &bestSolution);
  
+ /**
+  * @brief Rebuilds one subproblem of the search tree split at a fixed depth.
+  *
+  * Subproblem i follows the branches given by the bits of i (0: merge, 1: addEdge);
+  * the split depends on the graph only, so every process numbers it alike.
+  *
+  * @param g The root graph.
+  * @param splitDepth Depth of the split (2^splitDepth subproblems).
+  * @param index Number of the subproblem.
+  * @param task Output: the subproblem graph.
+  * @return False if the subproblem is empty (its path ends at a complete graph).
+  */
+ bool subproblemAt(const Graph &g, int splitDepth, long long index, Graph &task);
+
  /**
   * @brief Selects a branching pair of vertices (two nonadjacent vertices with high degree sum).
   * @param g The graph.
+  * @param bits The bitset matrix of g, if the caller already built it.
   * @return A pair of vertex indices to branch on.
   */
- std::pair<int,int> selectBranchingPair(const Graph &g);
+ std::pair<int,int> selectBranchingPair(const Graph &g, const NodeBitGraph *bits = nullptr);
  
  #endif // BRANCH_AND_BOUND_HPP
  
\ No newline at end of file
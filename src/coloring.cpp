@@ -0,0 +1,140 @@
+/**
+ * @file coloring.cpp
+ * @brief Implementation of the public C++ API of the coloring engine.
+ */
+
+ #include "coloring.hpp"
+ #include "branch_and_bound.hpp"
+ #include "component_scheduler.hpp"
+ #include "lower_bounds.hpp"
+ #include "node_queue.hpp"
+ #include "portfolio.hpp"
+ #include <omp.h>
+ #include <algorithm>
+
+ namespace {
+
+ /**
+  * @brief Sets the OpenMP thread count of the calling thread for the lifetime of the scope.
+  *
+  * Also covers the parallel regions of the graph routines that take no context; the
+  * setting is per calling thread, so concurrent solves do not interfere.
+  */
+ class ThreadCountScope {
+ public:
+     explicit ThreadCountScope(int threads) : saved(omp_get_max_threads()) { omp_set_num_threads(threads); }
+     ~ThreadCountScope() { omp_set_num_threads(saved); }
+
+ private:
+     int saved;
+ };
+
+ } // namespace
+
+ /**
+  * @brief Searches one connected component with the strategy of the context.
+  * @param g The component graph.
+  * @param bestSolution The incumbent (updated).
+  * @param ctx The search context.
+  */
+ void searchComponent(const Graph &g, ColoringSolution &bestSolution, SearchContext &ctx) {
+     if (ctx.searchStrategy != SearchStrategy::DepthFirst) {
+         searchNodeQueue({g}, bestSolution, ctx, 0);
+         return;
+     }
+     #pragma omp parallel num_threads(ctx.threads())
+     {
+         #pragma omp single nowait
+         {
+             branchAndBound(g, bestSolution, ctx, 0);
+         }
+     }
+ }
+
+ /**
+  * @brief Colors a graph with the minimum number of colors (within the time budget).
+  * @param g The graph.
+  * @param options The options.
+  * @return The coloring and the search statistics.
+  */
+ SolveResult solveColoring(const Graph &g, const SolveOptions &options) {
+     SearchContext ctx;
+     ctx.timeLimit = options.timeLimit;
+     ctx.numThreads = options.numThreads;
+     ctx.deterministicMode = options.deterministic;
+     ctx.randomSeed = options.seed;
+     ctx.lpBoundDepth = options.lpBoundDepth;
+     ctx.searchStrategy = options.strategy;
+     ctx.openNodeMemoryLimit = options.openNodeMemoryLimit;
+     ctx.memoryLimit = options.memoryLimit;
+     ThreadCountScope threads(ctx.threads());
+     bool warmStart = !options.initialColoring.empty() && isProperColoring(g, options.initialColoring);
+
+     // Trivial components are colored directly; the others are searched.
+     SolveResult result;
+     result.coloring.assign(g.n, -1);
+     int lowerBound = options.lowerBound;
+     vector<vector<int>> components = findConnectedComponents(g);
+     vector<int> general;
+     for (size_t i = 0; i < components.size(); i++) {
+         ComponentInfo info = classifyComponent(g, components[i], static_cast<int>(i));
+         lowerBound = std::max(lowerBound, info.lowerBound);
+         if (info.kind == ComponentKind::General) {
+             general.push_back(static_cast<int>(i));
+             continue;
+         }
+         result.numColors = std::max(result.numColors, colorTrivialComponent(g, components[i], info.kind, result.coloring));
+         vector<int> clique = {components[i][0]};
+         if (info.kind == ComponentKind::Clique)
+             clique = components[i];
+         else if (info.kind == ComponentKind::Bipartite)
+             clique.push_back(*g.neighbors(clique[0]).begin());
+         if (clique.size() > result.clique.size())
+             result.clique = std::move(clique);
+     }
+     vector<Graph> graphs = extractSubgraphs(g, components, general);
+
+     // Seed each component with the portfolio (or the initial coloring) and tighten the
+     // lower bound with the root pipeline.
+     vector<ColoringSolution> incumbents(graphs.size());
+     for (size_t k = 0; k < graphs.size(); k++) {
+         PortfolioResult seed = portfolioColoring(graphs[k], ctx, 0);
+         if (warmStart) {
+             pair<int, vector<int>> warm = restrictColoring(graphs[k], options.initialColoring);
+             if (warm.first <= seed.numColors) {
+                 seed.numColors = warm.first;
+                 seed.coloring = std::move(warm.second);
+             }
+         }
+         BoundContext bounds(graphs[k], 0, seed.numColors, seed.coloring, ctx.lpBoundDepth);
+         evaluateLowerBounds(bounds);
+         lowerBound = std::max(lowerBound, bounds.lowerBound);
+         if (bounds.clique.empty())  // The pipeline stopped before the clique bound.
+             bounds.clique = graphs[k].heuristicMaxClique().second;
+         if (bounds.clique.size() > result.clique.size()) {
+             result.clique.clear();
+             for (int v : bounds.clique)
+                 result.clique.push_back(graphs[k].rep[v]);
+         }
+         incumbents[k].numColors = seed.numColors;
+         incumbents[k].coloring = graphs[k].expandColoring(seed.coloring);
+     }
+
+     // Search the components; one solved to optimality raises the bound for the others.
+     ctx.colorTarget = lowerBound;
+     for (size_t k = 0; k < graphs.size(); k++) {
+         searchComponent(graphs[k], incumbents[k], ctx);
+         if (ctx.completed)
+             ctx.colorTarget = std::max(ctx.colorTarget.load(), incumbents[k].numColors);
+         result.numColors = std::max(result.numColors, incumbents[k].numColors);
+         for (int v : components[general[k]])
+             result.coloring[v] = incumbents[k].coloring[v];
+     }
+
+     result.optimal = ctx.completed;
+     result.lowerBound = result.optimal ? result.numColors : std::max(lowerBound, ctx.colorTarget.load());
+     result.nodes = ctx.nodesExplored;
+     result.memoryPeak = ctx.graphMemory.peak + ctx.taskMemory.peak;
+     result.seconds = ctx.elapsed();
+     return result;
+ }
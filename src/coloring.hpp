@@ -0,0 +1,81 @@
+/**
+ * @file coloring.hpp
+ * @brief Public C++ API of the coloring engine (the libcoloring library).
+ *
+ * The library holds the whole single-process solver: component decomposition, the
+ * heuristic portfolio, the lower-bound pipeline and the branch-and-bound search. It does
+ * not use MPI. Each call keeps its settings and statistics in its own SearchContext, so
+ * calls from different threads may run concurrently. Re-solving after a few edge edits
+ * is cheaper with resolveColoring() (incremental.hpp).
+ *
+ * @par Example:
+ * @code
+ *   Graph g = Graph::fromEdges(5, {{0, 1}, {1, 2}, {2, 3}, {3, 4}, {4, 0}});
+ *   SolveOptions options;
+ *   options.timeLimit = 0.01;
+ *   SolveResult r = solveColoring(g, options);  // r.numColors == 3, r.optimal
+ * @endcode
+ */
+
+ #ifndef COLORING_HPP
+ #define COLORING_HPP
+
+ #include "graph.hpp"
+ #include "search_context.hpp"
+ #include <vector>
+
+ /**
+  * @brief Options of one solve.
+  */
+ struct SolveOptions {
+     double timeLimit = 10.0;              ///< Time budget (in seconds).
+     int numThreads = 1;                   ///< OpenMP threads (0: OpenMP default).
+     bool deterministic = false;           ///< Reproducible search (see SearchContext::deterministicMode).
+     unsigned int seed = 0;                ///< Seed for the randomized heuristics.
+     int lpBoundDepth = 0;                 ///< Depth below which the LP bound is computed (0: never).
+     SearchStrategy strategy = SearchStrategy::DepthFirst;  ///< Node selection strategy.
+     long long openNodeMemoryLimit = 1LL << 30;             ///< Memory cap of the open-node queue (bytes).
+     long long memoryLimit = 0;            ///< Cap on the graph memory of the search (bytes, 0: none).
+     int lowerBound = 0;                   ///< A known lower bound on the chromatic number.
+     vector<int> initialColoring;          ///< A known proper coloring (ignored if empty or invalid).
+ };
+
+ /**
+  * @brief Result of one solve.
+  */
+ struct SolveResult {
+     int numColors = 0;                    ///< Number of colors of the coloring.
+     vector<int> coloring;                 ///< Color of each vertex (0..numColors-1 per component).
+     int lowerBound = 0;                   ///< Proven lower bound on the chromatic number.
+     vector<int> clique;                   ///< Largest clique found (original vertices), a bound witness.
+     bool optimal = false;                 ///< True if the search completed (numColors is optimal).
+     long long nodes = 0;                  ///< Branch-and-bound nodes explored.
+     long long memoryPeak = 0;             ///< Peak graph memory of the search (bytes, path and task graphs).
+     double seconds = 0;                   ///< Wall time of the solve.
+ };
+
+ /**
+  * @brief Colors a graph with the minimum number of colors (within the time budget).
+  *
+  * Trivial components are colored directly; the others are seeded by the heuristic
+  * portfolio (or the initial coloring, if better) and searched one after another.
+  *
+  * @param g The graph, built with Graph::fromEdges() or readGraphFromCOLFile() (no merges).
+  * @param options The options.
+  * @return The coloring and the search statistics.
+  */
+ SolveResult solveColoring(const Graph &g, const SolveOptions &options = SolveOptions());
+
+ /**
+  * @brief Searches one connected component with the strategy of the context.
+  *
+  * Runs the recursive depth-first search (as OpenMP tasks) or the open-node queue
+  * engine on ctx.threads() threads.
+  *
+  * @param g The component graph.
+  * @param bestSolution The incumbent (updated); its coloring is indexed by original vertex.
+  * @param ctx The search context.
+  */
+ void searchComponent(const Graph &g, ColoringSolution &bestSolution, SearchContext &ctx);
+
+ #endif // COLORING_HPP
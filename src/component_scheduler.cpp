@@ -0,0 +1,158 @@
+/**
+ * @file component_scheduler.cpp
+ * @brief Implementation of the connected-component classification and scheduling routines.
+ */
+
+ #include "component_scheduler.hpp"
+ #include <algorithm>
+ #include <queue>
+ #include <unordered_map>
+
+ /**
+  * @brief Tries to 2-color a component with BFS.
+  *
+  * @param fullG The full graph.
+  * @param vertices Vertex indices of the component.
+  * @param side Output: side[k] is the color (0 or 1) of vertices[k].
+  * @return True if the component is bipartite.
+  */
+ static bool twoColorComponent(const Graph &fullG, const vector<int> &vertices, vector<int> &side) {
+     unordered_map<int, int> local;
+     local.reserve(vertices.size());
+     for (int k = 0; k < (int)vertices.size(); k++)
+         local[vertices[k]] = k;
+     side.assign(vertices.size(), -1);
+     for (int start = 0; start < (int)vertices.size(); start++) {
+         if (side[start] != -1) continue;
+         side[start] = 0;
+         queue<int> Q;
+         Q.push(start);
+         while (!Q.empty()) {
+             int a = Q.front(); Q.pop();
+             for (int w : fullG.neighbors(vertices[a])) {
+                 int b = local[w];
+                 if (side[b] == -1) {
+                     side[b] = 1 - side[a];
+                     Q.push(b);
+                 } else if (side[b] == side[a]) {
+                     return false;
+                 }
+             }
+         }
+     }
+     return true;
+ }
+
+ /**
+  * @brief Classifies a connected component and estimates its difficulty.
+  *
+  * The cost estimate is n^2 + m, the dominant per-node cost of the Zykov branching.
+  *
+  * @param fullG The full graph.
+  * @param vertices Vertex indices of the component.
+  * @param index Index of the component in the component list.
+  * @return The component summary.
+  */
+ ComponentInfo classifyComponent(const Graph &fullG, const vector<int> &vertices, int index) {
+     ComponentInfo info;
+     info.index = index;
+     info.size = vertices.size();
+     long long degreeSum = 0;
+     for (int v : vertices)
+         degreeSum += fullG.degree(v);
+     info.edges = degreeSum / 2;
+
+     long long s = info.size;
+     vector<int> side;
+     if (info.size == 1)
+         info.kind = ComponentKind::Singleton;
+     else if (info.edges == s * (s - 1) / 2)
+         info.kind = ComponentKind::Clique;
+     else if (twoColorComponent(fullG, vertices, side))
+         info.kind = ComponentKind::Bipartite;
+     else
+         info.kind = ComponentKind::General;
+
+     // A non-bipartite component contains an odd cycle and needs at least 3 colors.
+     switch (info.kind) {
+     case ComponentKind::Singleton: info.lowerBound = 1; break;
+     case ComponentKind::Clique:    info.lowerBound = info.size; break;
+     case ComponentKind::Bipartite: info.lowerBound = 2; break;
+     default:                       info.lowerBound = 3; break;
+     }
+     info.cost = (info.kind == ComponentKind::General) ? (double)s * s + info.edges : 0.0;
+     return info;
+ }
+
+ /**
+  * @brief Colors a trivial component (singleton, clique or bipartite) without search.
+  * @param fullG The full graph.
+  * @param vertices Vertex indices of the component.
+  * @param kind The structural class of the component (must not be General).
+  * @param coloring Coloring indexed by vertex of fullG; the entries of the component are written.
+  * @return The number of colors used, which is optimal for the component.
+  */
+ int colorTrivialComponent(const Graph &fullG, const vector<int> &vertices, ComponentKind kind,
+                           vector<int> &coloring) {
+     switch (kind) {
+     case ComponentKind::Singleton:
+         coloring[vertices[0]] = 0;
+         return 1;
+     case ComponentKind::Clique:
+         for (int k = 0; k < (int)vertices.size(); k++)
+             coloring[vertices[k]] = k;
+         return vertices.size();
+     case ComponentKind::Bipartite: {
+         vector<int> side;
+         twoColorComponent(fullG, vertices, side);
+         for (int k = 0; k < (int)vertices.size(); k++)
+             coloring[vertices[k]] = side[k];
+         return 2;
+     }
+     default:
+         return INF;
+     }
+ }
+
+ /**
+  * @brief Assigns the nontrivial components to MPI ranks.
+  * @param infos Summaries of the nontrivial components.
+  * @param numRanks Number of MPI ranks.
+  * @return One assignment per component, ordered by decreasing cost.
+  */
+ vector<ComponentAssignment> scheduleComponents(const vector<ComponentInfo> &infos, int numRanks) {
+     vector<int> order(infos.size());
+     for (int k = 0; k < (int)order.size(); k++)
+         order[k] = k;
+     stable_sort(order.begin(), order.end(), [&](int a, int b) { return infos[a].cost > infos[b].cost; });
+
+     vector<ComponentAssignment> result(order.size());
+     if (order.empty())
+         return result;
+     if ((int)order.size() >= numRanks) {
+         // Longest processing time first: the next largest component goes to the least loaded rank.
+         vector<double> load(numRanks, 0.0);
+         for (int k = 0; k < (int)order.size(); k++) {
+             int rank = min_element(load.begin(), load.end()) - load.begin();
+             load[rank] += infos[order[k]].cost;
+             result[k] = {infos[order[k]].index, rank, 1};
+         }
+         return result;
+     }
+
+     // Fewer components than ranks: give the spare ranks to the groups with the highest cost per rank.
+     vector<int> groupSize(order.size(), 1);
+     for (int spare = numRanks - (int)order.size(); spare > 0; spare--) {
+         int best = 0;
+         for (int k = 1; k < (int)order.size(); k++)
+             if (infos[order[k]].cost / groupSize[k] > infos[order[best]].cost / groupSize[best])
+                 best = k;
+         groupSize[best]++;
+     }
+     int nextRank = 0;
+     for (int k = 0; k < (int)order.size(); k++) {
+         result[k] = {infos[order[k]].index, nextRank, groupSize[k]};
+         nextRank += groupSize[k];
+     }
+     return result;
+ }
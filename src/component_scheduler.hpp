@@ -0,0 +1,81 @@
+/**
+ * @file component_scheduler.hpp
+ * @brief Declaration of the connected-component classification and scheduling routines.
+ */
+
+ #ifndef COMPONENT_SCHEDULER_HPP
+ #define COMPONENT_SCHEDULER_HPP
+
+ #include "graph.hpp"
+ #include <vector>
+
+ /**
+  * @brief Structural class of a connected component.
+  *
+  * Every class except General can be colored optimally without search.
+  */
+ enum class ComponentKind {
+     Singleton,  ///< A single isolated vertex (1 color).
+     Clique,     ///< A complete graph (one color per vertex).
+     Bipartite,  ///< A bipartite graph with at least one edge (2 colors).
+     General     ///< Anything else: solved by branch-and-bound.
+ };
+
+ /**
+  * @brief Summary of a connected component used by the scheduler.
+  */
+ struct ComponentInfo {
+     int index;            ///< Index of the component in the component list.
+     int size;             ///< Number of vertices.
+     long long edges;      ///< Number of edges.
+     ComponentKind kind;   ///< Structural class of the component.
+     int lowerBound;       ///< Lower bound on the chromatic number (exact for trivial components).
+     double cost;          ///< Estimated difficulty (0 for trivial components).
+ };
+
+ /**
+  * @brief Ranks assigned to solve a component.
+  *
+  * The component is solved by the contiguous rank range [firstRank, firstRank + numRanks).
+  */
+ struct ComponentAssignment {
+     int component;   ///< Index of the component in the component list.
+     int firstRank;   ///< First MPI rank of the group.
+     int numRanks;    ///< Number of MPI ranks in the group.
+ };
+
+ /**
+  * @brief Classifies a connected component and estimates its difficulty.
+  * @param fullG The full graph.
+  * @param vertices Vertex indices of the component.
+  * @param index Index of the component in the component list.
+  * @return The component summary.
+  */
+ ComponentInfo classifyComponent(const Graph &fullG, const vector<int> &vertices, int index);
+
+ /**
+  * @brief Colors a trivial component (singleton, clique or bipartite) without search.
+  * @param fullG The full graph.
+  * @param vertices Vertex indices of the component.
+  * @param kind The structural class of the component (must not be General).
+  * @param coloring Coloring indexed by vertex of fullG; the entries of the component are written.
+  * @return The number of colors used, which is optimal for the component.
+  */
+ int colorTrivialComponent(const Graph &fullG, const vector<int> &vertices, ComponentKind kind,
+                           vector<int> &coloring);
+
+ /**
+  * @brief Assigns the nontrivial components to MPI ranks.
+  *
+  * With at least as many components as ranks, components are assigned one rank each by
+  * longest-processing-time-first on the estimated cost. With fewer components than ranks,
+  * every component gets its own group and the spare ranks are handed out to the groups
+  * with the highest cost per rank, so idle ranks help on the largest components.
+  *
+  * @param infos Summaries of the nontrivial components.
+  * @param numRanks Number of MPI ranks.
+  * @return One assignment per component, ordered by decreasing cost.
+  */
+ vector<ComponentAssignment> scheduleComponents(const vector<ComponentInfo> &infos, int numRanks);
+
+ #endif // COMPONENT_SCHEDULER_HPP
@@ -1,13 +1,11 @@
-/**
+ /**
  * @file globals.cpp
  * @brief Definition of global variables.
  */
 
  #include "globals.hpp"
 
- std::chrono::steady_clock::time_point startTime;
- bool searchCompleted = true;
  int mpi_rank = 0;
  int mpi_size = 1;
+ std::atomic<long long> arenaChunkAllocations(0);
  std::ofstream logStream;
- 
\ No newline at end of file
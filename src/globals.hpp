@@ -1,24 +1,16 @@
 /**
  * @file globals.hpp
- * @brief Declaration of global variables for timing, MPI, and logging.
+ * @brief Declaration of the process-wide global variables (MPI, arena statistics, logging).
+ *
+ * The settings and statistics of a solve live in its SearchContext (search_context.hpp).
  */
 
  #ifndef GLOBALS_HPP
  #define GLOBALS_HPP
  
- #include <chrono>
+ #include <atomic>
  #include <fstream>
  
- /**
-  * @brief Global start time of the program.
-  */
- extern std::chrono::steady_clock::time_point startTime;
- 
- /**
-  * @brief Flag indicating whether the search completed within the time limit.
-  */
- extern bool searchCompleted;
- 
  /**
   * @brief MPI rank of the current process.
   */
@@ -29,6 +21,11 @@
   */
  extern int mpi_size;
  
+ /**
+  * @brief Number of heap allocations made by the thread arenas of this process.
+  */
+ extern std::atomic<long long> arenaChunkAllocations;
+ 
  /**
   * @brief Global output log stream.
   */
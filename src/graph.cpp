@@ -4,10 +4,19 @@
  */
 
  #include "graph.hpp"
+ #include "arena.hpp"
+ #include "bitset_kernels.hpp"
+ #include "perf_counters.hpp"
+ #include "simd_kernels.hpp"
  #include <iostream>
  #include <sstream>
  #include <algorithm>
+ #include <atomic>
+ #include <optional>
  #include <queue>
+ #include <set>
+ #include <tuple>
+ #include <unordered_map>
  
  /**
   * @brief Default constructor for ColoringSolution.
@@ -20,75 +29,159 @@
   * @brief Constructs a graph with a specified number of vertices.
   * @param n_ Number of vertices.
   */
- Graph::Graph(int n_) : n(n_), orig_n(n_) {
-     adj.resize(n);
-     mapping.resize(n);
+ Graph::Graph(int n_) : n(n_), orig_n(n_), offsets(n_ + 1, 0) {
+     rep.resize(n);
      for (int i = 0; i < n; i++) {
-         mapping[i].push_back(i);
+         rep[i] = i;
      }
  }
  
  /**
   * @brief Default constructor for Graph.
   */
- Graph::Graph() : n(0), orig_n(0) {}
+ Graph::Graph() : n(0), orig_n(0), offsets(1, 0) {}
+ 
+ /**
+  * @brief Builds a graph from an undirected edge list.
+  *
+  * Both directions of every edge are bucketed by a counting pass, then each neighbor
+  * list is sorted and deduplicated and the lists are compacted in place.
+  *
+  * @param n_ Number of vertices.
+  * @param edges The edges (each listed once, in either direction).
+  * @return The graph.
+  */
+ Graph Graph::fromEdges(int n_, const vector<pair<int, int>> &edges) {
+     Graph g(n_);
+     auto valid = [n_](const pair<int, int> &e) {
+         return e.first >= 0 && e.first < n_ && e.second >= 0 && e.second < n_ && e.first != e.second;
+     };
+     for (const auto &e : edges)
+         if (valid(e)) {
+             g.offsets[e.first + 1]++;
+             g.offsets[e.second + 1]++;
+         }
+     for (int v = 0; v < n_; v++)
+         g.offsets[v + 1] += g.offsets[v];
+     g.targets.resize(g.offsets[n_]);
+     vector<long long> fill(g.offsets.begin(), g.offsets.end() - 1);
+     for (const auto &e : edges)
+         if (valid(e)) {
+             g.targets[fill[e.first]++] = e.second;
+             g.targets[fill[e.second]++] = e.first;
+         }
+ 
+     vector<long long> degree(n_ + 1, 0);
+     #pragma omp parallel for schedule(dynamic, 256)
+     for (int v = 0; v < n_; v++) {
+         auto first = g.targets.begin() + g.offsets[v], last = g.targets.begin() + g.offsets[v + 1];
+         sort(first, last);
+         degree[v + 1] = unique(first, last) - first;
+     }
+     // Compact the deduplicated lists; every list moves towards the front, so in order is safe.
+     long long out = 0;
+     for (int v = 0; v < n_; v++) {
+         long long from = g.offsets[v];
+         g.offsets[v] = out;
+         for (long long k = 0; k < degree[v + 1]; k++)
+             g.targets[out++] = g.targets[from + k];
+     }
+     g.offsets[n_] = out;
+     g.targets.resize(out);
+     g.targets.shrink_to_fit();
+     return g;
+ }
+ 
+ // --- Merge Log ---
+ 
+ /**
+  * @brief Constructs a merge record.
+  * @param merged_ Original vertex that was merged away.
+  * @param into_ Original vertex it was merged into.
+  * @param prev_ Previous merge on the path.
+  */
+ MergeRecord::MergeRecord(int merged_, int into_, shared_ptr<MergeRecord> prev_)
+     : merged(merged_), into(into_), prev(std::move(prev_)) {}
+ 
+ /**
+  * @brief Releases the exclusively owned part of the log iteratively.
+  *
+  * A long chain of uniquely owned records would otherwise be destroyed recursively.
+  */
+ MergeRecord::~MergeRecord() {
+     shared_ptr<MergeRecord> next = std::move(prev);
+     while (next && next.use_count() == 1)
+         next = std::move(next->prev);
+ }
  
  // --- Graph Member Functions ---
  
+ /**
+  * @brief Tests whether two vertices are adjacent.
+  *
+  * @param u First vertex.
+  * @param v Second vertex.
+  * @return True if the edge (u, v) exists.
+  */
+ bool Graph::hasEdge(int u, int v) const {
+     if (degree(u) > degree(v))
+         swap(u, v);
+     NeighborRange r = neighbors(u);
+     return binary_search(r.begin(), r.end(), v);
+ }
+ 
  /**
   * @brief Merges two vertices (Zykov branch "same color").
   *
-  * Combines vertices i and j into a single vertex, merging their adjacencies and
-  * original mappings.
+  * Combines vertices i and j into a single vertex, merging their adjacencies. The
+  * merged vertex keeps the representative of i and the merge is logged in O(1).
+  * Removing j shifts the later indices down by one, which keeps every neighbor list
+  * sorted, so the new graph is built in a single O(n + m) pass over the old one.
   *
   * @param i Index of the first vertex.
   * @param j Index of the second vertex.
   * @return A new Graph with vertices i and j merged.
   */
  Graph Graph::mergeVertices(int i, int j) const {
+     PerfRegion region(PerfPhase::Merge);
      Graph newG(n - 1);
      newG.orig_n = orig_n;
-     newG.adj.resize(newG.n);
-     newG.mapping.resize(newG.n);
+     newG.merges = make_shared<MergeRecord>(rep[j], rep[i], merges);
+     newG.targets.reserve(targets.size());
+     auto newIndex = [j](int w) { return w - (w > j); };
  
-     // Build newIndices: all vertices except j.
-     vector<int> newIndices;
-     newIndices.reserve(n - 1);
+     int a = 0;
      for (int k = 0; k < n; k++) {
          if (k == j) continue;
-         newIndices.push_back(k);
-     }
- 
-     // Merge the mappings for the merged vertex.
-     for (int a = 0; a < newG.n; a++) {
-         int oldIndex = newIndices[a];
-         if (oldIndex == i) {
-             newG.mapping[a] = mapping[i];
-             newG.mapping[a].insert(newG.mapping[a].end(), mapping[j].begin(), mapping[j].end());
-         } else {
-             newG.mapping[a] = mapping[oldIndex];
-         }
-     }
- 
-     // Rebuild the adjacency list.
-     for (int a = 0; a < newG.n; a++) {
-         for (int b = a + 1; b < newG.n; b++) {
-             int origA = newIndices[a];
-             int origB = newIndices[b];
-             bool connected = false;
-             if (origA == i || origB == i) {
-                 if (origA == i)
-                     connected = (adj[i].count(origB) || adj[j].count(origB));
-                 else
-                     connected = (adj[origA].count(i) || adj[origA].count(j));
-             } else {
-                 connected = (adj[origA].count(origB));
+         newG.rep[a] = rep[k];
+         if (k == i) {
+             // The merged vertex is adjacent to N(i) ∪ N(j).
+             NeighborRange ni = neighbors(i), nj = neighbors(j);
+             const int *p = ni.begin(), *q = nj.begin();
+             while (p != ni.end() || q != nj.end()) {
+                 int w;
+                 if (q == nj.end() || (p != ni.end() && *p < *q)) w = *p++;
+                 else if (p == ni.end() || *q < *p) w = *q++;
+                 else { w = *p++; q++; }
+                 if (w != i && w != j)
+                     newG.targets.push_back(newIndex(w));
              }
-             if (connected) {
-                 newG.adj[a].insert(b);
-                 newG.adj[b].insert(a);
+         } else {
+             // A neighbor of j becomes a neighbor of i (unless it already is one).
+             NeighborRange r = neighbors(k);
+             bool insertI = binary_search(r.begin(), r.end(), j) && !binary_search(r.begin(), r.end(), i);
+             for (int w : r) {
+                 if (insertI && w > i) {
+                     newG.targets.push_back(newIndex(i));
+                     insertI = false;
+                 }
+                 if (w != j)
+                     newG.targets.push_back(newIndex(w));
              }
+             if (insertI)
+                 newG.targets.push_back(newIndex(i));
          }
+         newG.offsets[++a] = newG.targets.size();
      }
      return newG;
  }
@@ -96,148 +189,319 @@
  /**
   * @brief Adds an edge between two vertices (Zykov branch "different color").
   *
+  * Copies the adjacency arrays once, inserting j into the list of i and i into the
+  * list of j at their sorted positions.
+  *
   * @param i Index of the first vertex.
   * @param j Index of the second vertex.
   * @return A new Graph with an edge added between vertices i and j.
   */
  Graph Graph::addEdge(int i, int j) const {
-     Graph newG = *this;
-     if (i < n && j < n) {
-         newG.adj[i].insert(j);
-         newG.adj[j].insert(i);
+     PerfRegion region(PerfPhase::AddEdge);
+     if (i >= n || j >= n || i == j || hasEdge(i, j))
+         return *this;
+     Graph newG;
+     newG.n = n;
+     newG.orig_n = orig_n;
+     newG.rep = rep;
+     newG.merges = merges;
+     newG.offsets.resize(n + 1);
+     newG.targets.resize(targets.size() + 2);
+     auto out = newG.targets.begin();
+     for (int v = 0; v < n; v++) {
+         NeighborRange r = neighbors(v);
+         if (v == i || v == j) {
+             int extra = (v == i) ? j : i;
+             const int *split = lower_bound(r.begin(), r.end(), extra);
+             out = copy(r.begin(), split, out);
+             *out++ = extra;
+             out = copy(split, r.end(), out);
+         } else {
+             out = copy(r.begin(), r.end(), out);
+         }
+         newG.offsets[v + 1] = out - newG.targets.begin();
      }
      return newG;
  }
  
+ /**
+  * @brief Expands a coloring of the current vertices to the original vertices.
+  *
+  * Every merge record points a merged original vertex at the vertex it was merged
+  * into; following these links (with path compression) always ends at the
+  * representative of a current vertex, or at a vertex outside this graph.
+  *
+  * @param coloring Color of each current vertex.
+  * @return Color of each original vertex (-1 for vertices not in this graph).
+  */
+ vector<int> Graph::expandColoring(const vector<int> &coloring) const {
+     vector<int> parent(orig_n);
+     for (int v = 0; v < orig_n; v++)
+         parent[v] = v;
+     for (const MergeRecord *r = merges.get(); r; r = r->prev.get())
+         parent[r->merged] = r->into;
+ 
+     vector<int> result(orig_n, -1);
+     for (int i = 0; i < n; i++)
+         result[rep[i]] = coloring[i];
+     for (int v = 0; v < orig_n; v++) {
+         int root = v;
+         while (parent[root] != root)
+             root = parent[root];
+         for (int x = v; parent[x] != x; ) {
+             int next = parent[x];
+             parent[x] = root;
+             x = next;
+         }
+         result[v] = result[root];
+     }
+     return result;
+ }
+ 
  /**
   * @brief Helper function implementing the Bron–Kerbosch algorithm.
   *
-  * Recursively finds the maximum clique in the graph.
+  * Recursively finds the maximum clique in the graph; branches that cannot beat the
+  * best clique (|R| + |P| <= bestSize) are cut. P and X are kept sorted so the
+  * pivot counts |P ∩ N(u)| and the sets P ∩ N(v), X ∩ N(v) are computed with the SIMD
+  * sorted-intersection kernels. All candidate sets live in the thread arena: R must have
+  * capacity for n vertices, X is reserved here so that it never reallocates inside the
+  * per-branch arena scopes.
   *
-  * @param adj The graph's adjacency list.
+  * @param g The graph.
   * @param R The current clique being built.
-  * @param P Candidate vertices that can be added to the clique.
-  * @param X Vertices already processed.
+  * @param P Candidate vertices that can be added to the clique (sorted).
+  * @param X Vertices already processed (sorted).
   * @param bestSize Current best clique size.
   * @param bestClique Vertices forming the best clique.
   */
- static void bronKerbosch(const vector<unordered_set<int>> &adj,
-                          vector<int> &R, vector<int> &P, vector<int> &X,
+ static void bronKerbosch(const Graph &g,
+                          ArenaVector<int> &R, ArenaVector<int> &P, ArenaVector<int> &X,
                           int &bestSize, vector<int> &bestClique) {
      if (P.empty() && X.empty()) {
          if ((int)R.size() > bestSize) {
              bestSize = R.size();
-             bestClique = R;
+             bestClique.assign(R.begin(), R.end());
          }
          return;
      }
+     if ((int)(R.size() + P.size()) <= bestSize)
+         return;
+     X.reserve(X.size() + P.size());
      // Choose a pivot u from P ∪ X that maximizes |P ∩ N(u)|
      int pivot = -1;
      int maxCount = -1;
-     vector<int> unionPX;
-     unionPX.insert(unionPX.end(), P.begin(), P.end());
-     unionPX.insert(unionPX.end(), X.begin(), X.end());
-     for (int u : unionPX) {
-         int count = 0;
-         for (int w : P) {
-             if (adj[u].count(w))
-                 count++;
-         }
+     auto considerPivot = [&](int u) {
+         NeighborRange nu = g.neighbors(u);
+         int count = sortedIntersectCount(P.data(), P.size(), nu.begin(), nu.size());
          if (count > maxCount) {
              maxCount = count;
              pivot = u;
          }
-     }
-     vector<int> pWithoutPivot;
-     for (int v : P)
-         if (!adj[pivot].count(v))
-             pWithoutPivot.push_back(v);
+     };
+     for (int u : P) considerPivot(u);
+     for (int u : X) considerPivot(u);
+     NeighborRange np = g.neighbors(pivot);
+     ArenaVector<int> pWithoutPivot(P.size());
+     pWithoutPivot.resize(set_difference(P.begin(), P.end(), np.begin(), np.end(),
+                                         pWithoutPivot.begin()) - pWithoutPivot.begin());
      for (int v : pWithoutPivot) {
          R.push_back(v);
-         vector<int> newP, newX;
-         for (int w : P)
-             if (adj[v].count(w))
-                 newP.push_back(w);
-         for (int w : X)
-             if (adj[v].count(w))
-                 newX.push_back(w);
-         bronKerbosch(adj, R, newP, newX, bestSize, bestClique);
+         {
+             ArenaScope branchScope(threadArena());
+             NeighborRange nv = g.neighbors(v);
+             ArenaVector<int> newP(P.size()), newX(X.size());
+             newP.resize(sortedIntersect(P.data(), P.size(), nv.begin(), nv.size(), newP.data()));
+             newX.resize(sortedIntersect(X.data(), X.size(), nv.begin(), nv.size(), newX.data()));
+             bronKerbosch(g, R, newP, newX, bestSize, bestClique);
+         }
          R.pop_back();
-         P.erase(remove(P.begin(), P.end(), v), P.end());
-         X.push_back(v);
+         P.erase(lower_bound(P.begin(), P.end(), v));
+         X.insert(lower_bound(X.begin(), X.end(), v), v);
          if (P.empty())
              break;
      }
  }
  
+ /**
+  * @brief Computes a degeneracy ordering (repeated removal of a minimum-degree vertex).
+  *
+  * Uses the O(n + m) bucket algorithm of Batagelj and Zaversnik.
+  *
+  * @param g The graph.
+  * @return position[v] is the position of v in the ordering.
+  */
+ static ArenaVector<int> degeneracyPositions(const Graph &g) {
+     int n = g.n, maxDegree = 0;
+     ArenaVector<int> degree(n), position(n), vertexAt(n);
+     for (int v = 0; v < n; v++) {
+         degree[v] = g.degree(v);
+         maxDegree = max(maxDegree, degree[v]);
+     }
+     // bin[d] is the first position of the vertices of current degree d.
+     ArenaVector<int> bin(maxDegree + 1, 0);
+     for (int v = 0; v < n; v++)
+         bin[degree[v]]++;
+     for (int d = 0, start = 0; d <= maxDegree; d++) {
+         int count = bin[d];
+         bin[d] = start;
+         start += count;
+     }
+     for (int v = 0; v < n; v++) {
+         position[v] = bin[degree[v]]++;
+         vertexAt[position[v]] = v;
+     }
+     for (int d = maxDegree; d > 0; d--)
+         bin[d] = bin[d - 1];
+     bin[0] = 0;
+     for (int p = 0; p < n; p++) {
+         int v = vertexAt[p];
+         for (int u : g.neighbors(v)) {
+             if (degree[u] <= degree[v])
+                 continue;
+             // Move u to the front of its bin, then shrink the bin past it.
+             int du = degree[u], pu = position[u], pw = bin[du], w = vertexAt[pw];
+             if (u != w) {
+                 position[u] = pw;
+                 vertexAt[pu] = w;
+                 position[w] = pu;
+                 vertexAt[pw] = u;
+             }
+             bin[du]++;
+             degree[u]--;
+         }
+     }
+     return position;
+ }
+ 
  /**
   * @brief Colors the graph heuristically using the DSATUR algorithm.
   *
+  * Graphs with at most MAX_BITSET_VERTICES vertices use the fixed-width bitset kernel;
+  * larger ones use dsaturColoring() with ties broken by lowest index.
+  *
+  * @param bits The bitset matrix of this graph, built here if null.
   * @return A pair where the first element is the number of colors used and
   * the second element is the color assignment for each vertex.
   */
- pair<int, vector<int>> Graph::heuristicColoring() const {
-     int nLocal = n;
+ pair<int, vector<int>> Graph::heuristicColoring(const NodeBitGraph *bits) const {
+     PerfRegion region(PerfPhase::Dsatur);
+     ArenaScope scope(threadArena());
+     optional<NodeBitGraph> ownBits;
+     if (!bits)
+         bits = &ownBits.emplace(*this);
+     vector<int> bitColor;
+     int bitColors = 0;
+     if (bits->apply([&](const auto &bg) { bitColors = bitDsatur(bg, bitColor); }))
+         return {bitColors, bitColor};
+ 
+     vector<int> identity(n);
+     for (int v = 0; v < n; v++)
+         identity[v] = v;
+     vector<int> color = dsaturColoring(*this, identity);
+     int usedColors = 0;
+     for (int v = 0; v < n; v++)
+         usedColors = max(usedColors, color[v] + 1);
+     return {usedColors, color};
+ }
+ 
+ /**
+  * @brief DSATUR on the adjacency lists with ties broken by a given vertex rank.
+  *
+  * The uncolored vertices are kept in an ordered set keyed by (saturation, degree,
+  * rank), so each step costs O(log n) instead of a scan over all vertices. Scratch
+  * arrays are drawn from the thread arena and the color-usage marks are reset per step
+  * only at the touched entries instead of being reallocated.
+  *
+  * @param g The graph.
+  * @param tieRank A permutation of 0..n-1; among equal saturation and degree the vertex
+  *                with the lowest rank is colored first.
+  * @return The color of each vertex.
+  */
+ vector<int> dsaturColoring(const Graph &g, const vector<int> &tieRank) {
+     ArenaScope scope(threadArena());
+     int nLocal = g.n;
      vector<int> color(nLocal, -1);
-     vector<int> saturation(nLocal, 0);
-     vector<int> degree(nLocal, 0);
-     for (int i = 0; i < nLocal; i++)
-         degree[i] = adj[i].size();
- 
-     auto pickNextVertex = [&]() -> int {
-         int bestV = -1, bestSat = -1, bestDeg = -1;
-         for (int v = 0; v < nLocal; v++) {
-             if (color[v] == -1) {
-                 if (saturation[v] > bestSat || (saturation[v] == bestSat && degree[v] > bestDeg)) {
-                     bestV = v;
-                     bestSat = saturation[v];
-                     bestDeg = degree[v];
-                 }
-             }
-         }
-         return bestV;
-     };
+     ArenaVector<int> saturation(nLocal, 0), byRank(nLocal);
+     ArenaVector<char> used(nLocal + 1, 0);
+     for (int v = 0; v < nLocal; v++)
+         byRank[tieRank[v]] = v;
  
-     for (int step = 0; step < nLocal; step++) {
-         int v = pickNextVertex();
-         if (v == -1) break;
-         vector<bool> used(nLocal, false);
-         for (int w : adj[v])
+     // Highest saturation first, then highest degree, then lowest rank.
+     set<tuple<int, int, int>> uncolored;
+     for (int v = 0; v < nLocal; v++)
+         uncolored.emplace(0, -g.degree(v), tieRank[v]);
+ 
+     while (!uncolored.empty()) {
+         int v = byRank[get<2>(*uncolored.begin())];
+         uncolored.erase(uncolored.begin());
+         for (int w : g.neighbors(v))
              if (color[w] != -1)
-                 used[color[w]] = true;
+                 used[color[w]] = 1;
          int c = 0;
          while (c < nLocal && used[c])
              c++;
          color[v] = c;
-         for (int w : adj[v])
+         for (int w : g.neighbors(v))
+             if (color[w] != -1)
+                 used[color[w]] = 0;
+         // w gains saturation unless another neighbor (not v itself) already has color c.
+         for (int w : g.neighbors(v))
              if (color[w] == -1) {
                  bool seesC = false;
-                 for (int x : adj[w])
-                     if (color[x] == c) { seesC = true; break; }
-                 if (!seesC)
+                 for (int x : g.neighbors(w))
+                     if (x != v && color[x] == c) { seesC = true; break; }
+                 if (!seesC) {
+                     uncolored.erase(make_tuple(-saturation[w], -g.degree(w), tieRank[w]));
                      saturation[w]++;
+                     uncolored.emplace(-saturation[w], -g.degree(w), tieRank[w]);
+                 }
              }
      }
-     int usedColors = 0;
-     for (int v = 0; v < nLocal; v++)
-         usedColors = max(usedColors, color[v] + 1);
-     return {usedColors, color};
+     return color;
  }
  
  /**
   * @brief Computes a heuristic maximum clique using the Bron–Kerbosch algorithm.
   *
+  * Graphs with at most MAX_BITSET_VERTICES vertices use the fixed-width bitset kernel.
+  * Larger graphs are searched from every vertex v in degeneracy order with P and X
+  * restricted to the later and earlier neighbors of v, so no call ever works on a
+  * candidate set larger than the degeneracy of the graph.
+  *
+  * @param bits The bitset matrix of this graph, built here if null.
   * @return A pair where the first element is the clique size and the second element
   * is a list of vertices forming the clique.
   */
- pair<int, vector<int>> Graph::heuristicMaxClique() const {
-     vector<int> R, P, X;
-     P.resize(adj.size());
-     for (int i = 0; i < (int)adj.size(); i++)
-         P[i] = i;
+ pair<int, vector<int>> Graph::heuristicMaxClique(const NodeBitGraph *bits) const {
+     PerfRegion region(PerfPhase::MaxClique);
+     ArenaScope scope(threadArena());
+     optional<NodeBitGraph> ownBits;
+     if (!bits)
+         bits = &ownBits.emplace(*this);
+     vector<int> bitClique;
+     if (bits->apply([&](const auto &bg) { bitClique = bitMaxClique(bg); }))
+         return {(int)bitClique.size(), bitClique};
+ 
+     ArenaVector<int> position = degeneracyPositions(*this);
+     ArenaVector<int> order(n);
+     for (int v = 0; v < n; v++)
+         order[position[v]] = v;
+     ArenaVector<int> R;
+     R.reserve(n);
      int bestSize = 0;
      vector<int> bestClique;
-     bronKerbosch(adj, R, P, X, bestSize, bestClique);
+     for (int v : order) {
+         ArenaScope vertexScope(threadArena());
+         ArenaVector<int> P, X;
+         for (int w : neighbors(v))
+             (position[w] > position[v] ? P : X).push_back(w);
+         if ((int)P.size() + 1 <= bestSize)
+             continue;
+         R.push_back(v);
+         bronKerbosch(*this, R, P, X, bestSize, bestClique);
+         R.pop_back();
+     }
      return {bestSize, bestClique};
  }
  
@@ -265,6 +529,7 @@
              istringstream iss(line);
              string tmp;
              iss >> tmp >> tmp >> n >> m;
+             edges.reserve(m);
          }
          if (line[0] == 'e') {
              istringstream iss(line);
@@ -274,71 +539,210 @@
              edges.emplace_back(u - 1, v - 1);
          }
      }
-     Graph g(n);
-     for (auto &edge : edges) {
-         int u = edge.first, v = edge.second;
-         if (u >= 0 && u < n && v >= 0 && v < n) {
-             g.adj[u].insert(v);
-             g.adj[v].insert(u);
-         }
+     return Graph::fromEdges(n, edges);
+ }
+ 
+ /**
+  * @brief Reads a coloring from a file of "vertex color" lines (0-indexed vertices).
+  * @param filename Name of the coloring file.
+  * @param n Number of vertices of the graph.
+  * @return The color of each vertex (-1 for vertices not listed or out of range).
+  */
+ vector<int> readColoringFromFile(const string &filename, int n) {
+     ifstream infile(filename);
+     if (!infile) {
+         cerr << "Error opening file " << filename << endl;
+         exit(1);
+     }
+     vector<int> coloring(n, -1);
+     string line;
+     while (getline(infile, line)) {
+         if (line.find(':') != string::npos) continue;
+         istringstream iss(line);
+         int v, c;
+         if (iss >> v >> c && v >= 0 && v < n && c >= 0)
+             coloring[v] = c;
+     }
+     return coloring;
+ }
+ 
+ /**
+  * @brief Checks that every vertex has a color and no edge joins two equal colors.
+  * @param g The graph.
+  * @param coloring Color of each vertex of g.
+  * @return True if the coloring is proper and complete.
+  */
+ bool isProperColoring(const Graph &g, const vector<int> &coloring) {
+     if (static_cast<int>(coloring.size()) != g.n) return false;
+     for (int v = 0; v < g.n; v++) {
+         if (coloring[v] < 0) return false;
+         for (int w : g.neighbors(v))
+             if (coloring[w] == coloring[v]) return false;
+     }
+     return true;
+ }
+ 
+ /**
+  * @brief Restricts a coloring of the original vertices to a subgraph, renumbering its colors.
+  * @param g The subgraph.
+  * @param coloring Color of each original vertex.
+  * @return The number of colors and the color of each vertex of g (colors 0..k-1).
+  */
+ pair<int, vector<int>> restrictColoring(const Graph &g, const vector<int> &coloring) {
+     unordered_map<int, int> renumber;
+     vector<int> result(g.n);
+     for (int i = 0; i < g.n; i++) {
+         auto it = renumber.emplace(coloring[g.rep[i]], static_cast<int>(renumber.size())).first;
+         result[i] = it->second;
+     }
+     return {static_cast<int>(renumber.size()), result};
+ }
+ 
+ /**
+  * @brief Returns the root of x in a concurrent union-find forest, halving the path on the way.
+  */
+ static int findRoot(vector<atomic<int>> &parent, int x) {
+     while (true) {
+         int p = parent[x].load(memory_order_relaxed);
+         if (p == x) return x;
+         int gp = parent[p].load(memory_order_relaxed);
+         if (gp != p)
+             parent[x].compare_exchange_weak(p, gp, memory_order_relaxed);
+         x = gp;
      }
-     return g;
  }
  
  /**
-  * @brief Finds the connected components in the graph using BFS.
+  * @brief Joins the trees of a and b; the larger root is hooked under the smaller one with CAS.
+  */
+ static void uniteRoots(vector<atomic<int>> &parent, int a, int b) {
+     while (true) {
+         a = findRoot(parent, a);
+         b = findRoot(parent, b);
+         if (a == b) return;
+         if (a < b) swap(a, b);
+         int expected = a;
+         if (parent[a].compare_exchange_strong(expected, b, memory_order_relaxed))
+             return;
+     }
+ }
+ 
+ /**
+  * @brief Finds the connected components in the graph with a parallel union-find.
+  *
+  * The CSR edges of the graph are united concurrently; since roots are always the
+  * smallest vertex of their tree, components come out ordered by their smallest vertex
+  * and each component lists its vertices in increasing order.
+  *
   * @param g The graph.
   * @return A vector of connected components (each component is a vector of vertex indices).
   */
  vector<vector<int>> findConnectedComponents(const Graph &g) {
+     vector<atomic<int>> parent(g.n);
+     #pragma omp parallel for
+     for (int v = 0; v < g.n; v++)
+         parent[v].store(v, memory_order_relaxed);
+     #pragma omp parallel for schedule(dynamic, 256)
+     for (int v = 0; v < g.n; v++)
+         for (int w : g.neighbors(v))
+             if (w > v)
+                 uniteRoots(parent, v, w);
+ 
+     vector<int> root(g.n);
+     #pragma omp parallel for
+     for (int v = 0; v < g.n; v++)
+         root[v] = findRoot(parent, v);
+ 
+     // Number the components by their root and bucket the vertices.
+     vector<int> componentOf(g.n, -1);
      vector<vector<int>> components;
-     vector<bool> visited(g.n, false);
-     for (int start = 0; start < g.n; start++) {
-         if (!visited[start]) {
-             queue<int> Q;
-             Q.push(start);
-             visited[start] = true;
-             vector<int> comp;
-             comp.push_back(start);
-             while (!Q.empty()) {
-                 int v = Q.front(); Q.pop();
-                 for (int w : g.adj[v]) {
-                     if (!visited[w]) {
-                         visited[w] = true;
-                         Q.push(w);
-                         comp.push_back(w);
-                     }
-                 }
-             }
-             components.push_back(comp);
+     for (int v = 0; v < g.n; v++) {
+         if (root[v] == v) {
+             componentOf[v] = components.size();
+             components.emplace_back();
          }
+         components[componentOf[root[v]]].push_back(v);
      }
      return components;
  }
  
  /**
-  * @brief Extracts a subgraph corresponding to a given set of vertices.
+  * @brief Copies the vertices of one component into a subgraph using a global-to-local index map.
   *
   * @param fullG The full graph.
-  * @param vertices The vector of vertex indices defining the subgraph.
-  * @return A subgraph containing only the specified vertices.
+  * @param vertices The vertices of the component.
+  * @param localIndexOf Callable mapping a vertex of fullG to its index in the subgraph (-1 if absent).
+  * @return The subgraph, built in O(|vertices| + edges) when vertices is increasing
+  * (as for connected components); otherwise each neighbor list is sorted afterwards.
   */
- Graph extractSubgraph(const Graph &fullG, const vector<int> &vertices) {
+ template <typename LocalIndexOf>
+ static Graph buildSubgraph(const Graph &fullG, const vector<int> &vertices, LocalIndexOf localIndexOf) {
      Graph subG(vertices.size());
      subG.orig_n = fullG.orig_n;
+     subG.merges = fullG.merges;
+     long long degreeSum = 0;
+     for (int v : vertices)
+         degreeSum += fullG.degree(v);
+     subG.targets.reserve(degreeSum);
      for (int i = 0; i < (int)vertices.size(); i++) {
-         subG.mapping[i] = fullG.mapping[vertices[i]];
-     }
-     for (int i = 0; i < (int)vertices.size(); i++) {
-         for (int j = i + 1; j < (int)vertices.size(); j++) {
-             int oldi = vertices[i];
-             int oldj = vertices[j];
-             if (fullG.adj[oldi].count(oldj)) {
-                 subG.adj[i].insert(j);
-                 subG.adj[j].insert(i);
-             }
+         subG.rep[i] = fullG.rep[vertices[i]];
+         for (int w : fullG.neighbors(vertices[i])) {
+             int j = localIndexOf(w);
+             if (j >= 0)
+                 subG.targets.push_back(j);
          }
+         auto first = subG.targets.begin() + subG.offsets[i];
+         if (!is_sorted(first, subG.targets.end()))
+             sort(first, subG.targets.end());
+         subG.offsets[i + 1] = subG.targets.size();
      }
      return subG;
  }
- 
\ No newline at end of file
+ 
+ /**
+  * @brief Extracts a subgraph corresponding to a given set of vertices.
+  *
+  * @param fullG The full graph.
+  * @param vertices The vector of vertex indices defining the subgraph.
+  * @return A subgraph containing only the specified vertices.
+  */
+ Graph extractSubgraph(const Graph &fullG, const vector<int> &vertices) {
+     unordered_map<int, int> local;
+     local.reserve(vertices.size());
+     for (int i = 0; i < (int)vertices.size(); i++)
+         local[vertices[i]] = i;
+     return buildSubgraph(fullG, vertices, [&](int w) {
+         auto it = local.find(w);
+         return it == local.end() ? -1 : it->second;
+     });
+ }
+ 
+ /**
+  * @brief Extracts the subgraphs of several disjoint vertex sets in parallel.
+  *
+  * A single global-to-local index map is shared by all sets, so each subgraph is built
+  * in O(k + edges) and the sets are processed concurrently by the OpenMP threads.
+  *
+  * @param fullG The full graph.
+  * @param components Disjoint vertex sets (e.g. the connected components).
+  * @param which Indices of the sets to extract.
+  * @return The subgraphs, in the order given by which.
+  */
+ vector<Graph> extractSubgraphs(const Graph &fullG, const vector<vector<int>> &components,
+                                const vector<int> &which) {
+     vector<int> localIndex(fullG.n, -1);
+     vector<Graph> subgraphs(which.size());
+     #pragma omp parallel
+     {
+         #pragma omp for schedule(dynamic)
+         for (int k = 0; k < (int)which.size(); k++) {
+             const vector<int> &vertices = components[which[k]];
+             for (int i = 0; i < (int)vertices.size(); i++)
+                 localIndex[vertices[i]] = i;
+         }
+         #pragma omp for schedule(dynamic)
+         for (int k = 0; k < (int)which.size(); k++)
+             subgraphs[k] = buildSubgraph(fullG, components[which[k]], [&](int w) { return localIndex[w]; });
+     }
+     return subgraphs;
+ }
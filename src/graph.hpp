@@ -7,7 +7,7 @@
  #define GRAPH_HPP
  
  #include <vector>
- #include <unordered_set>
+ #include <memory>
  #include <utility>
  #include <string>
  #include <queue>
@@ -21,6 +21,8 @@
   */
  const int INF = 1000000000;
  
+ struct NodeBitGraph;
+ 
  /**
   * @brief Structure to hold a complete graph coloring solution.
   */
@@ -34,17 +36,61 @@
      ColoringSolution();
  };
  
+ /**
+  * @brief One merge of the Zykov "same color" branch, stored over original vertex IDs.
+  *
+  * The records form a persistent (immutable, structurally shared) union-find log: each
+  * graph points at the newest merge on its path from the root of the search tree, and
+  * children share the log of their parent.
+  */
+ struct MergeRecord {
+     int merged;                     ///< Original vertex that was merged away.
+     int into;                       ///< Original vertex it was merged into.
+     shared_ptr<MergeRecord> prev;   ///< Previous merge on the path (nullptr at the root).
+ 
+     /**
+      * @brief Constructs a merge record.
+      * @param merged_ Original vertex that was merged away.
+      * @param into_ Original vertex it was merged into.
+      * @param prev_ Previous merge on the path.
+      */
+     MergeRecord(int merged_, int into_, shared_ptr<MergeRecord> prev_);
+ 
+     /**
+      * @brief Releases the exclusively owned part of the log iteratively (no deep recursion).
+      */
+     ~MergeRecord();
+ };
+ 
+ /**
+  * @brief A contiguous, sorted range of neighbor indices.
+  */
+ struct NeighborRange {
+     const int *first;  ///< First neighbor.
+     const int *last;   ///< One past the last neighbor.
+ 
+     const int *begin() const { return first; }
+     const int *end() const { return last; }
+     int size() const { return static_cast<int>(last - first); }
+ };
+ 
  /**
   * @brief A sparse graph representation.
+  *
+  * The adjacency is stored in compressed sparse row (CSR) form with every neighbor list
+  * sorted, which takes two words per edge plus one per vertex and makes neighbor scans
+  * sequential memory reads.
   */
  struct Graph {
      int n;         ///< Current number of vertices (after merges).
      int orig_n;    ///< Original number of vertices.
-     vector<unordered_set<int>> adj;  ///< Sparse adjacency list.
-     vector<vector<int>> mapping;     ///< mapping[i] holds the original vertex IDs merged into vertex i.
+     vector<long long> offsets;       ///< Neighbors of v are targets[offsets[v] .. offsets[v + 1]).
+     vector<int> targets;             ///< Concatenated neighbor lists, each strictly increasing.
+     vector<int> rep;                 ///< rep[i] is the original vertex ID representing vertex i.
+     shared_ptr<MergeRecord> merges;  ///< Newest merge applied to this graph (nullptr if none).
  
      /**
-      * @brief Constructs a graph with a given number of vertices.
+      * @brief Constructs a graph with a given number of vertices and no edges.
       * @param n_ Number of vertices.
       */
      Graph(int n_);
@@ -54,11 +100,57 @@
       */
      Graph();
  
+     /**
+      * @brief Builds a graph from an undirected edge list.
+      *
+      * Self-loops and duplicate edges are dropped; edges with an endpoint outside
+      * [0, n) are ignored.
+      *
+      * @param n_ Number of vertices.
+      * @param edges The edges (each listed once, in either direction).
+      * @return The graph.
+      */
+     static Graph fromEdges(int n_, const vector<pair<int, int>> &edges);
+ 
+     /**
+      * @brief Returns the sorted neighbors of a vertex.
+      * @param v The vertex.
+      */
+     NeighborRange neighbors(int v) const {
+         return {targets.data() + offsets[v], targets.data() + offsets[v + 1]};
+     }
+ 
+     /**
+      * @brief Returns the degree of a vertex.
+      * @param v The vertex.
+      */
+     int degree(int v) const { return static_cast<int>(offsets[v + 1] - offsets[v]); }
+ 
+     /**
+      * @brief Returns the number of edges.
+      */
+     long long numEdges() const { return static_cast<long long>(targets.size()) / 2; }
+ 
+     /**
+      * @brief Returns the heap memory owned by the graph (excluding the shared merge log), in bytes.
+      */
+     long long memoryBytes() const {
+         return static_cast<long long>(sizeof(Graph) + offsets.capacity() * sizeof(long long)
+                                       + (targets.capacity() + rep.capacity()) * sizeof(int));
+     }
+ 
+     /**
+      * @brief Tests whether two vertices are adjacent (binary search in the shorter list).
+      * @param u First vertex.
+      * @param v Second vertex.
+      */
+     bool hasEdge(int u, int v) const;
+ 
      /**
       * @brief Merges two vertices (Zykov branch "same color").
       *
-      * Merges vertex i and vertex j into one vertex, combining their adjacency
-      * and original vertex mappings.
+      * Merges vertex i and vertex j into one vertex, combining their adjacency.
+      * The merge is recorded in O(1) by prepending a record to the shared merge log.
       *
       * @param i Index of the first vertex.
       * @param j Index of the second vertex.
@@ -80,15 +172,28 @@
  
      /**
       * @brief Heuristically computes the maximum clique using Bron–Kerbosch algorithm.
+      * @param bits The bitset matrix of this graph, if the caller already built it.
       * @return A pair containing the size of the clique and the vertices forming the clique.
       */
-     pair<int, vector<int>> heuristicMaxClique() const;
+     pair<int, vector<int>> heuristicMaxClique(const NodeBitGraph *bits = nullptr) const;
  
      /**
       * @brief Colors the graph heuristically using the DSATUR algorithm.
+      * @param bits The bitset matrix of this graph, if the caller already built it.
       * @return A pair containing the number of colors used and the color assignment.
       */
-     pair<int, vector<int>> heuristicColoring() const;
+     pair<int, vector<int>> heuristicColoring(const NodeBitGraph *bits = nullptr) const;
+ 
+     /**
+      * @brief Expands a coloring of the current vertices to the original vertices.
+      *
+      * Replays the merge log into a union-find over the original vertices and resolves
+      * every original vertex in a single pass.
+      *
+      * @param coloring Color of each current vertex.
+      * @return Color of each original vertex (-1 for vertices not in this graph).
+      */
+     vector<int> expandColoring(const vector<int> &coloring) const;
  };
  
  /**
@@ -99,12 +204,48 @@
  Graph readGraphFromCOLFile(const string &filename);
  
  /**
-  * @brief Finds connected components in a graph using BFS.
+  * @brief Reads a coloring from a file of "vertex color" lines (0-indexed vertices).
+  *
+  * This is the format of the solver output, so a previous .output file can be read
+  * directly: its "key: value" header lines are skipped.
+  *
+  * @param filename Name of the coloring file.
+  * @param n Number of vertices of the graph.
+  * @return The color of each vertex (-1 for vertices not listed or out of range).
+  */
+ vector<int> readColoringFromFile(const string &filename, int n);
+ 
+ /**
+  * @brief Checks that every vertex has a color and no edge joins two equal colors.
+  * @param g The graph.
+  * @param coloring Color of each vertex of g.
+  * @return True if the coloring is proper and complete.
+  */
+ bool isProperColoring(const Graph &g, const vector<int> &coloring);
+ 
+ /**
+  * @brief Restricts a coloring of the original vertices to a subgraph, renumbering its colors.
+  * @param g The subgraph (e.g. a component extracted with extractSubgraph()).
+  * @param coloring Color of each original vertex.
+  * @return The number of colors and the color of each vertex of g (colors 0..k-1).
+  */
+ pair<int, vector<int>> restrictColoring(const Graph &g, const vector<int> &coloring);
+ 
+ /**
+  * @brief Finds connected components in a graph using a parallel union-find.
   * @param g The graph.
   * @return A vector of components, where each component is a vector of vertex indices.
   */
  vector<vector<int>> findConnectedComponents(const Graph &g);
  
+ /**
+  * @brief DSATUR with ties (equal saturation and degree) broken by a given vertex rank.
+  * @param g The graph.
+  * @param tieRank A permutation of 0..n-1; lower ranks are colored first on ties.
+  * @return The color of each vertex.
+  */
+ vector<int> dsaturColoring(const Graph &g, const vector<int> &tieRank);
+ 
  /**
   * @brief Extracts a subgraph corresponding to a set of vertices from the full graph.
   * @param fullG The full graph.
@@ -113,5 +254,15 @@
   */
  Graph extractSubgraph(const Graph &fullG, const vector<int> &vertices);
  
+ /**
+  * @brief Extracts the subgraphs of several disjoint vertex sets in parallel.
+  * @param fullG The full graph.
+  * @param components Disjoint vertex sets (e.g. the connected components).
+  * @param which Indices of the sets to extract.
+  * @return The subgraphs, in the order given by which.
+  */
+ vector<Graph> extractSubgraphs(const Graph &fullG, const vector<vector<int>> &components,
+                                const vector<int> &which);
+ 
  #endif // GRAPH_HPP
  
\ No newline at end of file
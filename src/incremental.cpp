@@ -0,0 +1,222 @@
+/**
+ * @file incremental.cpp
+ * @brief Implementation of the incremental re-solve after edge edits.
+ */
+
+ #include "incremental.hpp"
+ #include <algorithm>
+ #include <chrono>
+
+ // Tuning parameters.
+ static const long long REPAIR_WORK_PER_VISIT = 20;  ///< Repair budget, in multiples of n + 2m vertex and edge visits.
+
+ namespace {
+
+ /**
+  * @brief Recolors single vertices within a fixed number of colors (Kempe-chain interchanges).
+  *
+  * Uncolored vertices have color -1 and are ignored by the chains; the coloring of the
+  * colored vertices stays proper after every operation.
+  */
+ class KempeRepair {
+ public:
+     KempeRepair(const Graph &g_, vector<int> &color_, long long budget)
+         : g(g_), color(color_), work(budget), visited(g_.n, 0), blocked(g_.n, 0) {}
+
+     /**
+      * @brief Gives an uncolored vertex one of the colors 0..k-1.
+      * @param v The vertex.
+      * @param k Number of colors.
+      * @return False if no free color was found within the budget (v stays uncolored).
+      */
+     bool recolor(int v, int k) {
+         stamp++;
+         taken.resize(std::max<size_t>(taken.size(), k), 0);
+         for (int w : g.neighbors(v))
+             if (color[w] >= 0 && color[w] < k) taken[color[w]] = stamp;
+         work -= g.degree(v);
+         for (int c = 0; c < k; c++)
+             if (taken[c] != stamp) {
+                 color[v] = c;
+                 return true;
+             }
+         for (int a = 0; a < k; a++)
+             for (int b = 0; b < k; b++) {
+                 if (work <= 0) return false;
+                 if (a != b && swapChains(v, a, b)) {
+                     color[v] = a;
+                     return true;
+                 }
+             }
+         return false;
+     }
+
+     /**
+      * @brief Moves the vertices of color k-1 to the colors 0..k-2.
+      * @param k Number of colors.
+      * @return True on success; otherwise the coloring is left unchanged.
+      */
+     bool dropTopColor(int k) {
+         vector<int> saved = color;
+         for (int v = 0; v < g.n; v++) {
+             if (color[v] != k - 1) continue;
+             color[v] = -1;
+             if (!recolor(v, k - 1)) {
+                 color.swap(saved);
+                 return false;
+             }
+         }
+         return true;
+     }
+
+ private:
+     /**
+      * @brief Swaps colors a and b on the (a, b) Kempe chains through the a-colored neighbors of v.
+      *
+      * Afterwards no neighbor of v has color a, unless a chain reaches a b-colored neighbor
+      * of v: then nothing is swapped.
+      *
+      * @return True if the chains were swapped.
+      */
+     bool swapChains(int v, int a, int b) {
+         stamp++;
+         chain.clear();
+         for (int w : g.neighbors(v)) {
+             if (color[w] == b) blocked[w] = stamp;
+             if (color[w] == a) {
+                 visited[w] = stamp;
+                 chain.push_back(w);
+             }
+         }
+         for (size_t i = 0; i < chain.size(); i++) {
+             work -= g.degree(chain[i]);
+             for (int y : g.neighbors(chain[i])) {
+                 if ((color[y] != a && color[y] != b) || visited[y] == stamp) continue;
+                 if (blocked[y] == stamp) return false;
+                 visited[y] = stamp;
+                 chain.push_back(y);
+             }
+             if (work <= 0) return false;
+         }
+         for (int x : chain)
+             color[x] = color[x] == a ? b : a;
+         return true;
+     }
+
+     const Graph &g;
+     vector<int> &color;
+     long long work;                 ///< Remaining vertex and edge visits.
+     long long stamp = 0;
+     vector<long long> visited;      ///< visited[x] == stamp: x is on the current chains.
+     vector<long long> blocked;      ///< blocked[x] == stamp: x is a b-colored neighbor of v.
+     vector<long long> taken;        ///< taken[c] == stamp: color c is used by a neighbor of v.
+     vector<int> chain;
+ };
+
+ } // namespace
+
+ /**
+  * @brief Applies edge edits to a graph.
+  * @param g The graph.
+  * @param delta The edits.
+  * @return The edited graph.
+  */
+ Graph applyEdgeDelta(const Graph &g, const EdgeDelta &delta) {
+     vector<pair<int, int>> removed;
+     for (auto [u, v] : delta.removed)
+         removed.emplace_back(std::min(u, v), std::max(u, v));
+     std::sort(removed.begin(), removed.end());
+     vector<pair<int, int>> edges;
+     edges.reserve(g.numEdges() + delta.added.size());
+     for (int u = 0; u < g.n; u++)
+         for (int v : g.neighbors(u))
+             if (u < v && !std::binary_search(removed.begin(), removed.end(), make_pair(u, v)))
+                 edges.emplace_back(u, v);
+     edges.insert(edges.end(), delta.added.begin(), delta.added.end());
+     return Graph::fromEdges(g.n, edges);
+ }
+
+ /**
+  * @brief Re-solves a graph after edge edits, starting from the previous solution.
+  * @param g The edited graph.
+  * @param previous The solution of the graph before the edits.
+  * @param delta The edits.
+  * @param options The options of the fallback search.
+  * @return The coloring and the search statistics.
+  */
+ SolveResult resolveColoring(const Graph &g, const SolveResult &previous, const EdgeDelta &delta,
+                             const SolveOptions &options) {
+     auto start = std::chrono::steady_clock::now();
+     auto elapsed = [&start]() {
+         return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+     };
+     if (static_cast<int>(previous.coloring.size()) != g.n)
+         return solveColoring(g, options);
+
+     // Only the added edges can conflict: uncolor one endpoint of each, then recolor.
+     vector<int> color = previous.coloring;
+     int k = previous.numColors;
+     vector<int> uncolored;
+     for (int v = 0; v < g.n; v++) {
+         k = std::max(k, color[v] + 1);
+         if (color[v] < 0) uncolored.push_back(v);
+     }
+     for (auto [u, v] : delta.added) {
+         if (u < 0 || u >= g.n || v < 0 || v >= g.n || u == v || color[u] < 0 || color[u] != color[v])
+             continue;
+         int w = g.degree(u) < g.degree(v) ? u : v;
+         color[w] = -1;
+         uncolored.push_back(w);
+     }
+     KempeRepair repair(g, color, REPAIR_WORK_PER_VISIT * (g.n + 2 * g.numEdges() + 1));
+     for (int v : uncolored)
+         if (!repair.recolor(v, k)) color[v] = k++;
+     if (!isProperColoring(g, color))  // The previous coloring did not match the edits.
+         return solveColoring(g, options);
+
+     // Bounds that survive the edits: the previous clique without its broken part, and
+     // the previous bound lowered by one per removed edge.
+     vector<int> clique;
+     for (int v : previous.clique) {
+         if (v < 0 || v >= g.n) continue;
+         bool adjacent = true;
+         for (int u : clique)
+             adjacent = adjacent && g.hasEdge(u, v);
+         if (adjacent) clique.push_back(v);
+     }
+     int lowerBound = std::max({options.lowerBound, static_cast<int>(clique.size()),
+                                previous.lowerBound - static_cast<int>(delta.removed.size())});
+
+     // Local search: empty the top color class while the bound allows it.
+     while (k > lowerBound && repair.dropTopColor(k))
+         k--;
+     vector<int> renumber(k, -1);
+     int numColors = 0;
+     for (int &c : color) {
+         if (renumber[c] == -1) renumber[c] = numColors++;
+         c = renumber[c];
+     }
+
+     if (lowerBound >= numColors) {
+         SolveResult result;
+         result.numColors = numColors;
+         result.coloring = std::move(color);
+         result.lowerBound = numColors;
+         result.clique = std::move(clique);
+         result.optimal = true;
+         result.seconds = elapsed();
+         return result;
+     }
+
+     // The bounds do not meet: search, warm-started from the repaired coloring.
+     SolveOptions warm = options;
+     warm.timeLimit = std::max(0.0, options.timeLimit - elapsed());
+     warm.initialColoring = std::move(color);
+     warm.lowerBound = lowerBound;
+     double repairSeconds = elapsed();
+     SolveResult result = solveColoring(g, warm);
+     if (result.clique.size() < clique.size())
+         result.clique = std::move(clique);
+     result.seconds += repairSeconds;
+     return result;
+ }
@@ -0,0 +1,58 @@
+/**
+ * @file incremental.hpp
+ * @brief Declaration of the incremental re-solve after edge edits (part of libcoloring).
+ *
+ * After a few edge edits most of a previous solution still holds: the coloring can only
+ * conflict on the added edges, and the clique behind the lower bound survives unless a
+ * removed edge lies inside it. resolveColoring() repairs the coloring locally with
+ * Kempe-chain interchanges, keeps the bounds that remain valid and runs the
+ * branch-and-bound search only when they do not meet.
+ */
+
+ #ifndef INCREMENTAL_HPP
+ #define INCREMENTAL_HPP
+
+ #include "coloring.hpp"
+ #include <utility>
+ #include <vector>
+
+ /**
+  * @brief A set of edge edits (0-indexed vertices, either direction); the vertices do not change.
+  */
+ struct EdgeDelta {
+     vector<pair<int, int>> added;    ///< Edges inserted into the graph.
+     vector<pair<int, int>> removed;  ///< Edges deleted from the graph.
+ };
+
+ /**
+  * @brief Applies edge edits to a graph.
+  * @param g The graph, built with Graph::fromEdges() or readGraphFromCOLFile() (no merges).
+  * @param delta The edits; removals are applied first, and edits of absent edges are ignored.
+  * @return The edited graph.
+  */
+ Graph applyEdgeDelta(const Graph &g, const EdgeDelta &delta);
+
+ /**
+  * @brief Re-solves a graph after edge edits, starting from the previous solution.
+  *
+  * Each added edge whose endpoints share a color uncolors its endpoint of smaller degree;
+  * the uncolored vertices take a free color or one freed by a Kempe-chain interchange,
+  * and a new color only if both fail. The top color class is then emptied the same way
+  * while that succeeds. The lower bound is the largest of the previous clique (if still
+  * complete; otherwise the part of it untouched by the removals), the previous bound
+  * minus the number of removed edges (a removal lowers the chromatic number by at most
+  * one) and options.lowerBound. If it meets the repaired coloring, the result is optimal
+  * without any search; otherwise solveColoring() runs, warm-started from the repaired
+  * coloring and the bound.
+  *
+  * @param g The edited graph (e.g. from applyEdgeDelta()).
+  * @param previous The solution of the graph before the edits.
+  * @param delta The edits that lead from the previous graph to g.
+  * @param options The options of the fallback search (initialColoring and lowerBound are
+  *                replaced by the repaired coloring and the bound, if stronger).
+  * @return The coloring and the search statistics (nodes is 0 if no search ran).
+  */
+ SolveResult resolveColoring(const Graph &g, const SolveResult &previous, const EdgeDelta &delta,
+                             const SolveOptions &options = SolveOptions());
+
+ #endif // INCREMENTAL_HPP
@@ -0,0 +1,367 @@
+/**
+ * @file lower_bounds.cpp
+ * @brief Implementation of the lower-bound pipeline.
+ */
+
+ #include "lower_bounds.hpp"
+ #include "arena.hpp"
+ #include "lp_bound.hpp"
+ #include "perf_counters.hpp"
+ #include <algorithm>
+ #include <cmath>
+ #include <cstdint>
+
+ // Tuning parameters.
+ static const int HOFFMAN_MAX_VERTICES = 256;  ///< Largest graph for the dense eigenvalue bound.
+ static const int HOFFMAN_MAX_DEPTH    = 3;    ///< The Hoffman bound runs at nodes shallower than this.
+
+ // --- Structural bound ---
+
+ /**
+  * @brief 1 for an edgeless graph, 2 for a bipartite one, 3 if there is an odd cycle.
+  */
+ static int structureBound(BoundContext &ctx) {
+     const Graph &g = ctx.g;
+     if (g.n == 0) return 0;
+     if (g.numEdges() == 0) return 1;
+     ArenaScope scope(threadArena());
+     ArenaVector<int> side(g.n, -1), queue(g.n);
+     for (int s = 0; s < g.n; s++) {
+         if (side[s] != -1) continue;
+         side[s] = 0;
+         int head = 0, tail = 0;
+         queue[tail++] = s;
+         while (head < tail) {
+             int v = queue[head++];
+             for (int w : g.neighbors(v)) {
+                 if (side[w] == -1) {
+                     side[w] = 1 - side[v];
+                     queue[tail++] = w;
+                 } else if (side[w] == side[v]) {
+                     return 3;
+                 }
+             }
+         }
+     }
+     return 2;
+ }
+
+ // --- Independence-number bound ---
+
+ /**
+  * @brief ceil(n / k) for a greedy partition of the vertices into k cliques.
+  *
+  * An independent set meets every clique at most once, so k bounds the independence
+  * number from above and every color class has at most k vertices.
+  */
+ static int cliqueCoverBound(BoundContext &ctx) {
+     const Graph &g = ctx.g;
+     if (g.n == 0) return 0;
+     ArenaScope scope(threadArena());
+     ArenaVector<int> order(g.n), start(g.n + 1, 0), members, touched;
+     ArenaVector<int> adjacentMembers(g.n, 0);
+     ArenaVector<char> assigned(g.n, 0);
+     // Vertices by decreasing degree (counting sort, stable).
+     for (int v = 0; v < g.n; v++)
+         start[g.n - 1 - g.degree(v) + 1]++;
+     for (int d = 0; d < g.n; d++)
+         start[d + 1] += start[d];
+     for (int v = 0; v < g.n; v++)
+         order[start[g.n - 1 - g.degree(v)]++] = v;
+     int cliques = 0;
+     for (int v : order) {
+         if (assigned[v]) continue;
+         cliques++;
+         members.assign(1, v);
+         assigned[v] = 1;
+         auto addMember = [&](int x) {
+             for (int y : g.neighbors(x)) {
+                 if (adjacentMembers[y]++ == 0)
+                     touched.push_back(y);
+             }
+         };
+         addMember(v);
+         for (int u : g.neighbors(v))
+             if (!assigned[u] && adjacentMembers[u] == (int)members.size()) {
+                 members.push_back(u);
+                 assigned[u] = 1;
+                 addMember(u);
+             }
+         for (int y : touched)
+             adjacentMembers[y] = 0;
+         touched.clear();
+     }
+     return (g.n + cliques - 1) / cliques;
+ }
+
+ // --- Mycielskian recognition ---
+
+ /**
+  * @brief Order-dependent hash of the neighbors of v that pass a filter (in adjacency order).
+  */
+ template <typename Filter>
+ static uint64_t neighborhoodHash(const Graph &g, int v, Filter keep) {
+     uint64_t h = 0xcbf29ce484222325ULL;
+     for (int x : g.neighbors(v))
+         if (keep(x)) h = (h ^ static_cast<uint64_t>(x)) * 0x100000001b3ULL;
+     return h;
+ }
+
+ /**
+  * @brief True if the filtered neighbors of u and of w are the same (sorted) sequence.
+  */
+ template <typename FilterU, typename FilterW>
+ static bool sameNeighborhood(const Graph &g, int u, FilterU keepU, int w, FilterW keepW) {
+     auto a = g.neighbors(u), b = g.neighbors(w);
+     auto i = a.begin(), j = b.begin();
+     while (true) {
+         while (i != a.end() && !keepU(*i)) ++i;
+         while (j != b.end() && !keepW(*j)) ++j;
+         if (i == a.end() || j == b.end()) return i == a.end() && j == b.end();
+         if (*i++ != *j++) return false;
+     }
+ }
+
+ /**
+  * @brief Recognizes g as the Mycielskian M(H) of a graph H.
+  *
+  * M(H) has a copy U of H, a shadow w_i of every u_i adjacent to the H-neighbors of u_i,
+  * and a root z adjacent to all shadows. The root therefore has degree (n - 1) / 2 and an
+  * independent neighborhood W; the shadows are matched to U by their neighborhoods, and
+  * the U-W edges are checked against the matching.
+  *
+  * @param g The graph.
+  * @param base Output: the vertices of U (increasing), which induce H.
+  * @return True if g is a Mycielskian.
+  */
+ static bool findMycielskiBase(const Graph &g, vector<int> &base) {
+     int n = g.n;
+     if (n < 5 || n % 2 == 0) return false;
+     int k = (n - 1) / 2;
+     ArenaScope scope(threadArena());
+     ArenaVector<char> role(n);     // 0: U, 1: W (shadows), 2: z (root).
+     ArenaVector<int> shadowOf(n);  // shadowOf[u] is the shadow matched to u.
+     ArenaVector<char> matched(n);  // The vertex of U has a shadow.
+     ArenaVector<std::pair<uint64_t, int>> byHash;
+     ArenaVector<int> expected, actual;
+     byHash.reserve(n);
+     for (int z = 0; z < n; z++) {
+         if (g.degree(z) != k) continue;
+         std::fill(role.begin(), role.end(), 0);
+         role[z] = 2;
+         for (int w : g.neighbors(z))
+             role[w] = 1;
+         bool ok = true;
+         for (int w : g.neighbors(z)) {
+             for (int x : g.neighbors(w))
+                 if (role[x] == 1) { ok = false; break; }
+             if (!ok) break;
+         }
+         if (!ok) continue;
+
+         // Match every shadow to a vertex of U with the same U-neighborhood: the vertices
+         // of U are sorted by the hash of their neighborhood, and each shadow takes an
+         // unmatched one with an equal hash and neighborhood.
+         auto inU = [&](int x) { return role[x] == 0; };
+         auto notRoot = [&](int x) { return x != z; };
+         byHash.clear();
+         for (int u = 0; u < n; u++)
+             if (role[u] == 0) byHash.emplace_back(neighborhoodHash(g, u, inU), u);
+         std::sort(byHash.begin(), byHash.end());
+         std::fill(matched.begin(), matched.end(), 0);
+         for (int w : g.neighbors(z)) {
+             uint64_t h = neighborhoodHash(g, w, notRoot);
+             auto it = std::lower_bound(byHash.begin(), byHash.end(), std::make_pair(h, -1));
+             for (; it != byHash.end() && it->first == h; ++it)
+                 if (!matched[it->second] && sameNeighborhood(g, it->second, inU, w, notRoot)) break;
+             if (it == byHash.end() || it->first != h) { ok = false; break; }
+             matched[it->second] = 1;
+             shadowOf[it->second] = w;
+         }
+         if (!ok) continue;
+
+         // The shadows adjacent to u must be exactly the shadows of the U-neighbors of u.
+         for (int u = 0; u < n && ok; u++) {
+             if (role[u] != 0) continue;
+             expected.clear();
+             actual.clear();
+             for (int x : g.neighbors(u)) {
+                 if (role[x] == 0) expected.push_back(shadowOf[x]);
+                 else actual.push_back(x);
+             }
+             std::sort(expected.begin(), expected.end());
+             ok = expected == actual;
+         }
+         if (!ok) continue;
+
+         base.clear();
+         for (int u = 0; u < n; u++)
+             if (role[u] == 0) base.push_back(u);
+         return true;
+     }
+     return false;
+ }
+
+ /**
+  * @brief chi(M(H)) = chi(H) + 1: one more than the pipeline bound of H.
+  */
+ static int mycielskiBound(BoundContext &ctx) {
+     vector<int> base;
+     if (!findMycielskiBase(ctx.g, base)) return 0;
+     Graph h = extractSubgraph(ctx.g, base);
+     vector<int> coloring = h.heuristicColoring().second;
+     BoundContext inner(h, ctx.depth, INF, coloring, ctx.lpBoundDepth);
+     evaluateLowerBounds(inner);
+     return inner.lowerBound + 1;
+ }
+
+ // --- Clique bound ---
+
+ static int cliqueBound(BoundContext &ctx) {
+     auto [size, clique] = ctx.g.heuristicMaxClique(ctx.bits);
+     ctx.clique = std::move(clique);
+     return size;
+ }
+
+ // --- Hoffman bound ---
+
+ /**
+  * @brief Reduces a dense symmetric matrix to tridiagonal form (Householder reflections).
+  * @param a Row-major n x n matrix (overwritten).
+  * @param n Dimension.
+  * @param d Output: diagonal.
+  * @param e Output: off-diagonal, e[i] couples i and i + 1.
+  */
+ static void tridiagonalize(ArenaVector<double> &a, int n, ArenaVector<double> &d, ArenaVector<double> &e) {
+     ArenaVector<double> v(n), p(n);
+     for (int k = 0; k + 2 < n; k++) {
+         int m = n - k - 1;  // Length of the column below the diagonal.
+         double norm = 0;
+         for (int i = 0; i < m; i++) {
+             v[i] = a[(k + 1 + i) * n + k];
+             norm += v[i] * v[i];
+         }
+         norm = std::sqrt(norm);
+         if (norm == 0) continue;
+         double alpha = v[0] > 0 ? -norm : norm;
+         v[0] -= alpha;
+         double vv = 0;
+         for (int i = 0; i < m; i++) vv += v[i] * v[i];
+         if (vv == 0) continue;
+         double beta = 2.0 / vv;
+         // p = beta * A22 v, q = p - (beta / 2)(v^T p) v, A22 -= v q^T + q v^T.
+         double vp = 0;
+         for (int i = 0; i < m; i++) {
+             double s = 0;
+             for (int j = 0; j < m; j++)
+                 s += a[(k + 1 + i) * n + (k + 1 + j)] * v[j];
+             p[i] = beta * s;
+             vp += v[i] * p[i];
+         }
+         double K = 0.5 * beta * vp;
+         for (int i = 0; i < m; i++)
+             p[i] -= K * v[i];
+         for (int i = 0; i < m; i++)
+             for (int j = 0; j < m; j++)
+                 a[(k + 1 + i) * n + (k + 1 + j)] -= v[i] * p[j] + p[i] * v[j];
+         a[(k + 1) * n + k] = a[k * n + (k + 1)] = alpha;
+         for (int i = 1; i < m; i++)
+             a[(k + 1 + i) * n + k] = a[k * n + (k + 1 + i)] = 0;
+     }
+     for (int i = 0; i < n; i++) {
+         d[i] = a[i * n + i];
+         if (i + 1 < n) e[i] = a[(i + 1) * n + i];
+     }
+ }
+
+ /**
+  * @brief Number of eigenvalues of a symmetric tridiagonal matrix smaller than x (Sturm count).
+  */
+ static int eigenvaluesBelow(const ArenaVector<double> &d, const ArenaVector<double> &e, int n, double x) {
+     int count = 0;
+     double q = 1;
+     for (int i = 0; i < n; i++) {
+         double off = i > 0 ? e[i - 1] * e[i - 1] : 0.0;
+         q = d[i] - x - (i > 0 ? off / q : 0.0);
+         if (q == 0) q = -1e-300;
+         if (q < 0) count++;
+     }
+     return count;
+ }
+
+ /**
+  * @brief Hoffman's bound 1 + lambda_max / |lambda_min| of the adjacency matrix.
+  *
+  * The extreme eigenvalues are bracketed by bisection on the Sturm count of the
+  * tridiagonal form; the bound uses the lower end of both brackets (minus a margin for
+  * roundoff), so it never overestimates.
+  */
+ static int hoffmanBound(BoundContext &ctx) {
+     const Graph &g = ctx.g;
+     int n = g.n;
+     if (g.numEdges() == 0) return n > 0 ? 1 : 0;
+     ArenaScope scope(threadArena());
+     ArenaVector<double> a((size_t)n * n, 0.0), d(n), e(n, 0.0);
+     for (int v = 0; v < n; v++)
+         for (int w : g.neighbors(v))
+             a[(size_t)v * n + w] = 1.0;
+     tridiagonalize(a, n, d, e);
+     double radius = 0;
+     for (int i = 0; i < n; i++)
+         radius = std::max(radius, std::fabs(d[i]) + (i > 0 ? std::fabs(e[i - 1]) : 0.0) + std::fabs(e[i]));
+     auto lowerEnd = [&](int index) {  // Lower end of the bracket of the index-th smallest eigenvalue.
+         double lo = -radius - 1, hi = radius + 1;
+         for (int it = 0; it < 100 && hi - lo > 1e-12; it++) {
+             double mid = 0.5 * (lo + hi);
+             if (eigenvaluesBelow(d, e, n, mid) > index) hi = mid;
+             else lo = mid;
+         }
+         return lo;
+     };
+     const double margin = 1e-9 * (radius + 1);
+     double lambdaMin = lowerEnd(0) - margin;
+     double lambdaMax = lowerEnd(n - 1) - margin;
+     if (lambdaMin >= 0 || lambdaMax <= 0) return 1;
+     return (int)std::ceil(1.0 + lambdaMax / -lambdaMin - 1e-9);
+ }
+
+ // --- Fractional chromatic number ---
+
+ static int fractionalBound(BoundContext &ctx) {
+     return fractionalChromaticBound(ctx.g, ctx.coloring, ctx.lowerBound, ctx.target).bound;
+ }
+
+ // --- Pipeline ---
+
+ /**
+  * @brief Returns the bounds of the pipeline, in evaluation order (cheapest first).
+  */
+ const vector<LowerBoundRule> &lowerBoundPipeline() {
+     static const vector<LowerBoundRule> rules = {
+         {"structure",    [](const BoundContext &ctx) { return ctx.target <= 3; }, structureBound},
+         {"clique_cover", [](const BoundContext &) { return true; }, cliqueCoverBound},
+         {"mycielski",    [](const BoundContext &ctx) { return ctx.g.n % 2 == 1; }, mycielskiBound},
+         {"clique",       [](const BoundContext &) { return true; }, cliqueBound},
+         {"hoffman",      [](const BoundContext &ctx) {
+              return ctx.depth < HOFFMAN_MAX_DEPTH && ctx.g.n <= HOFFMAN_MAX_VERTICES; }, hoffmanBound},
+         {"fractional",   [](const BoundContext &ctx) { return ctx.depth < ctx.lpBoundDepth; }, fractionalBound},
+     };
+     return rules;
+ }
+
+ /**
+  * @brief Evaluates the pipeline until a bound reaches ctx.target.
+  * @param ctx The node context.
+  * @return Index of the bound that reached the target, or -1 if none did.
+  */
+ int evaluateLowerBounds(BoundContext &ctx) {
+     PerfRegion region(PerfPhase::Bounds);
+     const vector<LowerBoundRule> &rules = lowerBoundPipeline();
+     for (int r = 0; r < (int)rules.size(); r++) {
+         if (!rules[r].enabled(ctx)) continue;
+         ctx.lowerBound = std::max(ctx.lowerBound, rules[r].compute(ctx));
+         if (ctx.lowerBound >= ctx.target)
+             return r;
+     }
+     return -1;
+ }
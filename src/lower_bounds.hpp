@@ -0,0 +1,68 @@
+/**
+ * @file lower_bounds.hpp
+ * @brief Declaration of the lower-bound pipeline evaluated at every search node.
+ *
+ * The pipeline is an ordered table of bounds, cheapest first. At a node the bounds are
+ * evaluated in order until one of them reaches the pruning target; the index of that
+ * bound is reported so the caller can attribute the prune in its statistics
+ * (SearchContext::boundPrunes). Adding a
+ * bound means adding one row to the table in lower_bounds.cpp.
+ */
+
+ #ifndef LOWER_BOUNDS_HPP
+ #define LOWER_BOUNDS_HPP
+
+ #include "graph.hpp"
+ #include <vector>
+
+ /**
+  * @brief Search-node data shared by the bounds of the pipeline.
+  */
+ struct BoundContext {
+     const Graph &g;                 ///< The node graph.
+     int depth;                      ///< Depth of the node in the search tree.
+     int target;                     ///< The node is pruned once a bound reaches this value.
+     const vector<int> &coloring;    ///< A proper coloring of g (initial LP columns).
+     int lpBoundDepth;               ///< The LP bound runs at nodes shallower than this.
+     int lowerBound = 0;             ///< Largest bound computed so far.
+     vector<int> clique;             ///< Clique found by the clique bound (empty if not run).
+     const NodeBitGraph *bits = nullptr;  ///< Bitset matrix of g built by the caller, if any.
+
+     /**
+      * @brief Creates the context of a node.
+      * @param g_ The node graph.
+      * @param depth_ Depth of the node.
+      * @param target_ Pruning target (usually the incumbent).
+      * @param coloring_ A proper coloring of g_.
+      * @param lpBoundDepth_ Depth below which the LP bound is evaluated (0: never).
+      */
+     BoundContext(const Graph &g_, int depth_, int target_, const vector<int> &coloring_,
+                  int lpBoundDepth_ = 0)
+         : g(g_), depth(depth_), target(target_), coloring(coloring_), lpBoundDepth(lpBoundDepth_) {}
+ };
+
+ /**
+  * @brief One lower bound of the pipeline.
+  */
+ struct LowerBoundRule {
+     const char *name;                          ///< Name used in the statistics.
+     bool (*enabled)(const BoundContext &ctx);  ///< Whether the bound is evaluated at this node.
+     int (*compute)(BoundContext &ctx);         ///< Computes the bound.
+ };
+
+ /**
+  * @brief Returns the bounds of the pipeline, in evaluation order.
+  */
+ const vector<LowerBoundRule> &lowerBoundPipeline();
+
+ /**
+  * @brief Evaluates the pipeline until a bound reaches ctx.target.
+  *
+  * ctx.lowerBound holds the largest bound computed on return.
+  *
+  * @param ctx The node context.
+  * @return Index of the bound that reached the target, or -1 if none did.
+  */
+ int evaluateLowerBounds(BoundContext &ctx);
+
+ #endif // LOWER_BOUNDS_HPP
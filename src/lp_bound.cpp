@@ -0,0 +1,413 @@
+/**
+ * @file lp_bound.cpp
+ * @brief Implementation of the fractional chromatic number bound by column generation.
+ */
+
+ #include "lp_bound.hpp"
+ #include "arena.hpp"
+ #include "bitset_kernels.hpp"
+ #include <algorithm>
+ #include <cmath>
+ #include <limits>
+
+ // Tuning parameters.
+ static const int MAX_COLUMNS = 400;               ///< Columns generated per bound at most.
+ static const long long MWIS_NODE_BUDGET = 20000;  ///< Search nodes per pricing problem.
+ static const double PIVOT_EPS = 1e-7;             ///< Smallest usable pivot element.
+ static const double FEAS_EPS = 1e-9;              ///< Feasibility and optimality tolerance.
+ static const int DEGENERATE_PIVOTS = 50;          ///< Degenerate pivots before switching to Bland's rule.
+ static const double PRICE_EPS = 1e-6;             ///< Minimum violation of a new column.
+ static const double ROUND_EPS = 1e-6;             ///< Slack when rounding the bound up.
+
+ /**
+  * @brief Dense simplex tableau of the dual of the restricted master problem.
+  *
+  * The dual is max sum y_v subject to y(S) <= 1 for every column S and y >= 0. The
+  * all-slack basis is feasible, so the first solve is a primal simplex; each new column
+  * adds a constraint that cuts off the current y, which the dual simplex then repairs
+  * from the previous optimal basis.
+  */
+ class DualTableau {
+ public:
+     /**
+      * @brief Creates a tableau over n dual variables and no constraints.
+      * @param n Number of vertices.
+      */
+     explicit DualTableau(int n) : n(n), obj(n, -1.0) {}
+
+     /**
+      * @brief Adds the constraint y(S) <= 1 with a new basic slack variable.
+      * @param members The vertices of the independent set S.
+      */
+     void addConstraint(const vector<int> &members) {
+         int m = rows.size();
+         for (auto &row : rows)
+             row.push_back(0.0);
+         obj.push_back(0.0);
+         vector<double> row(n + m + 1, 0.0);
+         for (int v : members)
+             row[v] = 1.0;
+         row[n + m] = 1.0;
+         double b = 1.0;
+         // Express the row in the current basis.
+         for (int i = 0; i < m; i++) {
+             double a = row[basis[i]];
+             if (a == 0.0) continue;
+             for (size_t j = 0; j < row.size(); j++)
+                 row[j] -= a * rows[i][j];
+             b -= a * rhs[i];
+         }
+         rows.push_back(std::move(row));
+         rhs.push_back(b);
+         basis.push_back(n + m);
+     }
+
+     /**
+      * @brief Reoptimizes: dual simplex while a row is infeasible, then primal simplex.
+      *
+      * Both ratio tests are Harris two-pass tests: the step is bounded with a small
+      * tolerance, then the largest pivot element within that bound is taken, which keeps
+      * the highly degenerate tableau well conditioned. After DEGENERATE_PIVOTS degenerate
+      * pivots in a row the row / column to improve is chosen by lowest index (Bland).
+      *
+      * @param maxPivots Pivot limit.
+      * @return True if the tableau is optimal.
+      */
+     bool solve(int maxPivots) {
+         int degenerate = 0;
+         for (int it = 0; it < maxPivots; it++) {
+             bool bland = degenerate >= DEGENERATE_PIVOTS;
+             int r = -1;
+             for (int i = 0; i < (int)rows.size(); i++)
+                 if (rhs[i] < -FEAS_EPS && (r < 0 || (bland ? basis[i] < basis[r] : rhs[i] < rhs[r])))
+                     r = i;
+             if (r >= 0) {
+                 double bound = std::numeric_limits<double>::infinity();
+                 for (int j = 0; j < (int)obj.size(); j++)
+                     if (rows[r][j] < -PIVOT_EPS)
+                         bound = std::min(bound, (std::max(obj[j], 0.0) + FEAS_EPS) / -rows[r][j]);
+                 int c = -1;
+                 for (int j = 0; j < (int)obj.size(); j++)
+                     if (rows[r][j] < -PIVOT_EPS && std::max(obj[j], 0.0) / -rows[r][j] <= bound &&
+                         (c < 0 || rows[r][j] < rows[r][c]))
+                         c = j;
+                 if (c < 0) return false;
+                 degenerate = obj[c] <= FEAS_EPS ? degenerate + 1 : 0;
+                 pivot(r, c);
+                 continue;
+             }
+             int c = -1;
+             for (int j = 0; j < (int)obj.size(); j++)
+                 if (obj[j] < -FEAS_EPS && (c < 0 || (!bland && obj[j] < obj[c]))) {
+                     c = j;
+                     if (bland) break;
+                 }
+             if (c < 0) return true;
+             double bound = std::numeric_limits<double>::infinity();
+             for (int i = 0; i < (int)rows.size(); i++)
+                 if (rows[i][c] > PIVOT_EPS)
+                     bound = std::min(bound, (std::max(rhs[i], 0.0) + FEAS_EPS) / rows[i][c]);
+             r = -1;
+             for (int i = 0; i < (int)rows.size(); i++)
+                 if (rows[i][c] > PIVOT_EPS && std::max(rhs[i], 0.0) / rows[i][c] <= bound &&
+                     (r < 0 || rows[i][c] > rows[r][c]))
+                     r = i;
+             if (r < 0) return false;
+             degenerate = rhs[r] <= FEAS_EPS ? degenerate + 1 : 0;
+             pivot(r, c);
+         }
+         return false;
+     }
+
+     /**
+      * @brief Returns the current dual vector, clipped to y >= 0.
+      */
+     vector<double> solution() const {
+         vector<double> y(n, 0.0);
+         for (int i = 0; i < (int)rows.size(); i++)
+             if (basis[i] < n)
+                 y[basis[i]] = std::max(0.0, rhs[i]);
+         return y;
+     }
+
+     int numConstraints() const { return rows.size(); }
+
+ private:
+     int n;                          ///< Number of dual variables (vertices).
+     vector<vector<double>> rows;    ///< Constraint rows over the y and slack variables.
+     vector<double> rhs;             ///< Right-hand sides (values of the basic variables).
+     vector<int> basis;              ///< Basic variable of each row.
+     vector<double> obj;             ///< Reduced costs (optimal when all are >= 0).
+
+     void pivot(int r, int c) {
+         double p = rows[r][c];
+         for (double &a : rows[r]) a /= p;
+         rhs[r] /= p;
+         for (int i = 0; i < (int)rows.size(); i++) {
+             double f = rows[i][c];
+             if (i == r || f == 0.0) continue;
+             for (size_t j = 0; j < rows[i].size(); j++)
+                 rows[i][j] -= f * rows[r][j];
+             rhs[i] -= f * rhs[r];
+         }
+         double f = obj[c];
+         for (size_t j = 0; j < obj.size(); j++)
+             obj[j] -= f * rows[r][j];
+         basis[r] = c;
+     }
+ };
+
+ /**
+  * @brief Exact maximum weight independent set search with a node budget.
+  *
+  * Branch and bound over the candidate set P: P is greedily partitioned into cliques of
+  * the graph (an independent set takes at most one vertex of each), and the sum of the
+  * largest weights of the first k cliques bounds every extension drawn from them.
+  * Vertices are branched on from the last clique backwards, so the bound of the
+  * remaining candidates only shrinks.
+  */
+ template <int W>
+ struct IndependentSetSearch {
+     const BitGraph<W> &g;
+     const ArenaVector<FixedBitset<W>> &nonNeighbors;  ///< Complement rows (without the vertex itself).
+     const vector<double> &weight;
+     const ArenaVector<int> &byWeight;                 ///< Vertices by decreasing weight.
+     long long nodes = 0;
+     bool aborted = false;
+     double rootBound = 0;
+     double best = 0;
+     FixedBitset<W> current, bestSet;
+
+     IndependentSetSearch(const BitGraph<W> &g_, const ArenaVector<FixedBitset<W>> &nonNeighbors_,
+                          const vector<double> &weight_, const ArenaVector<int> &byWeight_)
+         : g(g_), nonNeighbors(nonNeighbors_), weight(weight_), byWeight(byWeight_) {
+         current.clear();
+         bestSet.clear();
+     }
+
+     void expand(FixedBitset<W> P, double w) {
+         if (++nodes > MWIS_NODE_BUDGET) { aborted = true; return; }
+         if (w > best) { best = w; bestSet = current; }
+         if (!P.any()) return;
+         ArenaScope scope(threadArena());
+         ArenaVector<FixedBitset<W>> common;  // Vertices adjacent to every member of each clique.
+         ArenaVector<double> cliqueMax;
+         ArenaVector<int> vertexClique, members;
+         for (int v : byWeight) {
+             if (!P.test(v)) continue;
+             int k = 0;
+             while (k < (int)common.size() && !common[k].test(v))
+                 k++;
+             if (k == (int)common.size()) {
+                 common.push_back(g.rows[v]);
+                 cliqueMax.push_back(weight[v]);
+             } else {
+                 common[k] = common[k] & g.rows[v];
+             }
+             members.push_back(v);
+             vertexClique.push_back(k);
+         }
+         // Order the candidates clique by clique, each with the bound of its prefix of cliques.
+         int numCliques = common.size();
+         ArenaVector<double> prefix(numCliques);
+         ArenaVector<int> start(numCliques + 1, 0);
+         for (int k = 0; k < numCliques; k++)
+             prefix[k] = cliqueMax[k] + (k > 0 ? prefix[k - 1] : 0.0);
+         for (int k : vertexClique)
+             start[k + 1]++;
+         for (int k = 0; k < numCliques; k++)
+             start[k + 1] += start[k];
+         ArenaVector<int> ordered(members.size());
+         for (size_t t = 0; t < members.size(); t++)
+             ordered[start[vertexClique[t]]++] = members[t];
+         if (nodes == 1)
+             rootBound = prefix[numCliques - 1];
+         // After the counting pass start[k] is the end of clique k.
+         for (int k = numCliques - 1; k >= 0; k--) {
+             for (int t = start[k] - 1; t >= (k > 0 ? start[k - 1] : 0); t--) {
+                 if (w + prefix[k] <= best) return;
+                 int v = ordered[t];
+                 current.set(v);
+                 expand(P & nonNeighbors[v], w + weight[v]);
+                 current.reset(v);
+                 if (aborted) return;
+                 P.reset(v);
+             }
+         }
+     }
+ };
+
+ /**
+  * @brief Greedy weighted independent sets used as cheap pricing heuristics.
+  *
+  * Two passes: one takes the candidates in order of decreasing weight, the other
+  * repeatedly takes the candidate maximizing weight / (candidate degree + 1).
+  *
+  * @param g The graph.
+  * @param weight Vertex weights.
+  * @param byWeight The vertices of positive weight, by decreasing weight.
+  * @param S Output: the heavier of the two sets.
+  * @return The weight of S.
+  */
+ template <int W>
+ static double greedyIndependentSet(const BitGraph<W> &g, const vector<double> &weight,
+                                    const ArenaVector<int> &byWeight, FixedBitset<W> &S) {
+     FixedBitset<W> candidates;
+     candidates.clear();
+     for (int v : byWeight)
+         candidates.set(v);
+
+     double first = 0;
+     FixedBitset<W> free = candidates;
+     S.clear();
+     for (int v : byWeight)
+         if (free.test(v)) {
+             S.set(v);
+             first += weight[v];
+             free = free.andNot(g.rows[v]);
+         }
+
+     double second = 0;
+     FixedBitset<W> T;
+     T.clear();
+     free = candidates;
+     while (free.any()) {
+         int pick = -1;
+         double bestScore = -1;
+         free.forEach([&](int v) {
+             double score = weight[v] / (free.andCount(g.rows[v]) + 1);
+             if (score > bestScore) { bestScore = score; pick = v; }
+         });
+         T.set(pick);
+         second += weight[pick];
+         free = free.andNot(g.rows[pick]);
+         free.reset(pick);
+     }
+     if (second > first) {
+         S = T;
+         return second;
+     }
+     return first;
+ }
+
+ /**
+  * @brief Extends an independent set to a maximal one (lowest indices first).
+  */
+ template <int W>
+ static void makeMaximal(const BitGraph<W> &g, FixedBitset<W> &S) {
+     FixedBitset<W> blocked = S;
+     S.forEach([&](int v) { blocked = blocked | g.rows[v]; });
+     for (int v = 0; v < g.n; v++)
+         if (!blocked.test(v)) {
+             S.set(v);
+             blocked.set(v);
+             blocked = blocked | g.rows[v];
+         }
+ }
+
+ /**
+  * @brief Column generation on a fixed-width bitset graph.
+  */
+ template <int W>
+ static FractionalBound generateColumns(const Graph &graph, const vector<int> &coloring, int lowerBound, int target) {
+     BitGraph<W> g(graph);
+     int n = g.n;
+     FractionalBound result{0.0, 0, 0, false};
+     ArenaVector<FixedBitset<W>> nonNeighbors(n);
+     FixedBitset<W> all;
+     all.fillFirst(n);
+     for (int v = 0; v < n; v++) {
+         nonNeighbors[v] = all.andNot(g.rows[v]);
+         nonNeighbors[v].reset(v);
+     }
+
+     auto addColumn = [&](DualTableau &lp, FixedBitset<W> S) {
+         makeMaximal(g, S);
+         vector<int> members;
+         S.forEach([&](int v) { members.push_back(v); });
+         lp.addConstraint(members);
+     };
+
+     // The color classes of the coloring are the initial columns.
+     DualTableau lp(n);
+     int numColors = 0;
+     for (int c : coloring)
+         numColors = std::max(numColors, c + 1);
+     for (int c = 0; c < numColors; c++) {
+         FixedBitset<W> S;
+         S.clear();
+         for (int v = 0; v < n; v++)
+             if (coloring[v] == c)
+                 S.set(v);
+         addColumn(lp, S);
+     }
+     int maxPivots = 50 * (n + numColors + MAX_COLUMNS);
+     bool solved = lp.solve(maxPivots);
+
+     while (true) {
+         vector<double> y = lp.solution();
+         double total = 0;
+         for (double yv : y)
+             total += yv;
+         // The restricted problem only overestimates the LP: stop if it cannot beat lowerBound.
+         if ((int)std::ceil(total - ROUND_EPS) <= lowerBound)
+             break;
+
+         ArenaScope scope(threadArena());
+         ArenaVector<int> byWeight;
+         for (int v = 0; v < n; v++)
+             if (y[v] > FEAS_EPS)
+                 byWeight.push_back(v);
+         std::stable_sort(byWeight.begin(), byWeight.end(), [&](int a, int b) { return y[a] > y[b]; });
+         FixedBitset<W> P;
+         P.clear();
+         for (int v : byWeight)
+             P.set(v);
+         // Cheap heuristic columns first; once the column limit is reached only the bound is computed.
+         bool full = lp.numConstraints() >= numColors + MAX_COLUMNS;
+         FixedBitset<W> column;
+         if (!full && greedyIndependentSet(g, y, byWeight, column) > 1.0 + PRICE_EPS) {
+             addColumn(lp, column);
+             solved = lp.solve(maxPivots);
+             continue;
+         }
+
+         // The exact search either finds a column or proves the restricted LP optimal.
+         IndependentSetSearch<W> search(g, nonNeighbors, y, byWeight);
+         search.expand(P, 0.0);
+         double alpha = search.aborted ? std::max(search.best, search.rootBound) : search.best;
+         if (alpha > FEAS_EPS)
+             result.value = std::max(result.value, total / alpha);
+         if ((int)std::ceil(result.value - ROUND_EPS) >= target)
+             break;
+         if (search.best <= 1.0 + PRICE_EPS) {
+             result.optimal = solved && !search.aborted;
+             break;
+         }
+         if (full)
+             break;
+         addColumn(lp, search.bestSet);
+         solved = lp.solve(maxPivots);
+     }
+     result.bound = std::max(0, (int)std::ceil(result.value - ROUND_EPS));
+     result.columns = lp.numConstraints();
+     return result;
+ }
+
+ /**
+  * @brief Lower bound on the chromatic number from the fractional chromatic number.
+  *
+  * @param g The graph.
+  * @param coloring A proper coloring of g; its color classes are the initial columns.
+  * @param lowerBound A known lower bound; generation stops once the LP cannot exceed it.
+  * @param target Generation stops as soon as the bound reaches this value.
+  * @return The bound (0 for graphs above MAX_BITSET_VERTICES vertices).
+  */
+ FractionalBound fractionalChromaticBound(const Graph &g, const vector<int> &coloring, int lowerBound, int target) {
+     ArenaScope scope(threadArena());
+     FractionalBound result{0.0, 0, 0, false};
+     dispatchByWidth(g.n, [&](auto width) {
+         result = generateColumns<decltype(width)::value>(g, coloring, lowerBound, target);
+     });
+     return result;
+ }
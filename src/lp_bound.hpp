@@ -0,0 +1,43 @@
+/**
+ * @file lp_bound.hpp
+ * @brief Declaration of the fractional chromatic number (LP) lower bound.
+ */
+
+ #ifndef LP_BOUND_HPP
+ #define LP_BOUND_HPP
+
+ #include "graph.hpp"
+ #include <vector>
+
+ /**
+  * @brief Result of the fractional chromatic number bound.
+  */
+ struct FractionalBound {
+     double value;   ///< Proven lower bound on the fractional chromatic number (0 if not computed).
+     int bound;      ///< The resulting lower bound on the chromatic number, ceil(value).
+     int columns;    ///< Number of independent sets in the final restricted master problem.
+     bool optimal;   ///< True if column generation proved the LP optimum.
+ };
+
+ /**
+  * @brief Lower bound on the chromatic number from the fractional chromatic number.
+  *
+  * Solves the LP min sum x_S subject to sum_{S ∋ v} x_S >= 1 (x >= 0) over the
+  * independent sets S of g by column generation. The dual of the restricted master
+  * problem is kept in a dense simplex tableau; new columns are priced by an exact
+  * (node-limited) maximum weight independent set search. Every dual vector y yields
+  * the valid bound sum(y) / alpha(y), where alpha(y) is (an upper bound on) the largest
+  * independent set weight, so the result is sound even when generation stops early.
+  *
+  * Only graphs with at most MAX_BITSET_VERTICES vertices are handled; for larger ones
+  * the returned bound is 0.
+  *
+  * @param g The graph.
+  * @param coloring A proper coloring of g; its color classes are the initial columns.
+  * @param lowerBound A known lower bound; generation stops once the LP cannot exceed it.
+  * @param target Generation stops as soon as the bound reaches this value (e.g. the incumbent).
+  * @return The bound.
+  */
+ FractionalBound fractionalChromaticBound(const Graph &g, const vector<int> &coloring, int lowerBound, int target);
+
+ #endif // LP_BOUND_HPP
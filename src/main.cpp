@@ -8,25 +8,56 @@
  *
  * The program reads a graph from an input file (expected in .col format with 1-indexed vertices), partitions the
  * graph into connected components, and then applies a branch-and-bound search to determine a valid coloring using
- * the minimum number of colors. For graphs with multiple components, each component is processed independently across
- * MPI processes. For a single connected component, a static task decomposition strategy is used.
+ * the minimum number of colors. Trivial components (singletons, cliques, bipartite graphs) are colored without search;
+ * the others are scheduled over the MPI processes by estimated difficulty, and components that get a group of several
+ * processes are solved with a static task decomposition. Processes that run out of components help on the
+ * largest one, whose subproblems are claimed through a shared counter.
  *
  * @note The input graph file must be in .col format.
  *
  * @par Usage Example:
  * @code
- *   mpirun -np <num_processes> ./solver <input_file.col> <time_limit_sec>
+ *   mpirun -np <num_processes> ./solver <input_file.col> <time_limit_sec> [options]
  * @endcode
+ *
+ * @par Options:
+ * - `--deterministic`: reproducible search (fixed node order, no OpenMP tasks in the tree search).
+ * - `--seed <n>`: seed for the randomized components of the solver.
+ * - `--lp-depth <d>`: compute the fractional chromatic (LP) bound at search nodes shallower than d.
+ * - `--strategy <s>`: node selection (dfs, best-bound, hybrid or lds; default dfs).
+ * - `--queue-memory-mb <n>`: memory cap of the open-node queue of the non-dfs strategies.
+ * - `--memory-limit-mb <n>`: cap on the graph memory of the search; near it, no more tasks are spawned.
+ * - `--decision <k>`: only decide whether the graph is k-colorable (stops at the first k-coloring).
+ * - `--init-coloring <file>`: start from a known coloring ("vertex color" lines, e.g. a previous .output file).
+ * - `--lower-bound <b>`: a known lower bound on the chromatic number.
+ * - `--batch`: the input file lists many graphs (paths or concatenated .col graphs), each solved
+ *   independently within the time limit (see batch.hpp).
+ * - `--perf-counters`: count CPU time, cycles, instructions, cache and branch misses per search
+ *   phase with perf_event_open (see perf_counters.hpp).
+ * - `--trace`: record a timeline of the search tasks of every thread and rank as a Chrome trace
+ *   (see trace.hpp).
+ * - `--progress <sec>`: rank 0 prints the bounds, gap, node rate and memory of all ranks every
+ *   sec seconds (see progress.hpp).
  */
 
  #include "globals.hpp"
  #include "graph.hpp"
+ #include "batch.hpp"
  #include "branch_and_bound.hpp"
+ #include "coloring.hpp"
+ #include "component_scheduler.hpp"
+ #include "lower_bounds.hpp"
+ #include "node_queue.hpp"
+ #include "perf_counters.hpp"
+ #include "portfolio.hpp"
+ #include "progress.hpp"
+ #include "stop_signal.hpp"
+ #include "simd_kernels.hpp"
+ #include "trace.hpp"
  
  #include <mpi.h>
  #include <omp.h>
  #include <iostream>
- #include <chrono>
  #include <fstream>
  #include <thread>
  #include <sstream>
@@ -38,10 +69,252 @@
  #include <cstring>
  #include <cstdlib>
  #include <unistd.h>
+ #include <functional>
+ #include <memory>
  
- using std::chrono::duration_cast;
- using std::chrono::duration;
- using std::chrono::steady_clock;
+ // Tuning parameters.
+ static const int HELP_TASKS_PER_RANK  = 8;   ///< Subproblems of the shared component per process.
+ static const int MAX_HELP_SPLIT_DEPTH = 12;  ///< Largest split depth of the shared component.
+ 
+/**
+ * @brief Solves one connected component cooperatively on a group of MPI processes.
+ *
+ * The search tree is statically decomposed into subproblems, which are distributed
+ * round-robin over the processes of the communicator; the best coloring is then
+ * broadcast to every process of the group.
+ *
+ * @param g The component graph.
+ * @param comm Communicator of the processes sharing the component.
+ * @param ctx The search context of this process.
+ * @param initial Initial incumbent of this process (e.g. from the portfolio).
+ * @param groupCompleted Output: true if every process of the group finished its
+ *        subproblems within the time limit.
+ * @return The best coloring found by the group (identical on every process).
+ */
+static ColoringSolution solveOnCommunicator(const Graph &g, MPI_Comm comm, SearchContext &ctx,
+                                            const ColoringSolution &initial, bool &groupCompleted) {
+    int commRank, commSize;
+    MPI_Comm_rank(comm, &commRank);
+    MPI_Comm_size(comm, &commSize);
+
+    // Decompose the search tree into smaller subproblems. The colorings of the
+    // decomposition nodes already improve the incumbent.
+    std::vector<Graph> tasks;
+    ColoringSolution localBest = initial;
+    decomposeBnb(g, 0, 2, tasks, ctx, localBest);
+    if (tasks.empty()) {
+        tasks.push_back(g);
+    }
+    long long taskBytes = 0;
+    for (const Graph &t : tasks)
+        taskBytes += t.memoryBytes();
+    MemoryCharge tasksCharge(ctx.taskMemory, taskBytes);
+
+    if (ctx.searchStrategy != SearchStrategy::DepthFirst) {
+        // The node-queue engine shares one queue between the assigned subproblems.
+        std::vector<Graph> assignedTasks;
+        for (size_t i = 0; i < tasks.size(); i++) {
+            if (static_cast<int>(i % commSize) == commRank) {
+                assignedTasks.push_back(std::move(tasks[i]));
+            }
+        }
+        searchNodeQueue(assignedTasks, localBest, ctx, 2);
+    } else if (ctx.deterministicMode) {
+        // Solve the assigned subproblems one after another in task order.
+        for (size_t i = 0; i < tasks.size(); i++) {
+            if (static_cast<int>(i % commSize) == commRank) {
+                TraceSpan span("subproblem", "index", static_cast<long long>(i));
+                branchAndBound(tasks[i], localBest, ctx, 2);
+            }
+        }
+    } else {
+        #pragma omp parallel
+        {
+            #pragma omp single nowait
+            {
+                for (size_t i = 0; i < tasks.size(); i++) {
+                    if (static_cast<int>(i % commSize) == commRank) {
+                        ctx.openTasks++;
+                        #pragma omp task firstprivate(i)
+                        {
+                            TraceSpan span("subproblem", "index", static_cast<long long>(i));
+                            branchAndBound(tasks[i], localBest, ctx, 2);
+                            ctx.openTasks--;
+                        }
+                    }
+                }
+                #pragma omp taskwait
+            }
+        }
+    }
+
+    // Determine the MPI process with the best solution.
+    struct { int value; int rank; } localPair, globalPair;
+    localPair.value = localBest.numColors;
+    localPair.rank  = commRank;
+    MPI_Request request;
+    MPI_Iallreduce(&localPair, &globalPair, 1, MPI_2INT, MPI_MINLOC, comm, &request);
+    waitWithProgress(request, ctx);
+
+    // The group search is complete only if every process completed its subproblems.
+    int localCompleted = ctx.completed ? 1 : 0;
+    int allCompleted = 0;
+    MPI_Iallreduce(&localCompleted, &allCompleted, 1, MPI_INT, MPI_LAND, comm, &request);
+    waitWithProgress(request, ctx);
+    groupCompleted = (allCompleted != 0);
+
+    // Broadcast the best coloring solution from the process that found it.
+    ColoringSolution groupBest;
+    groupBest.numColors = globalPair.value;
+    groupBest.coloring.assign(g.orig_n, -1);
+    if (commRank == globalPair.rank) {
+        groupBest.coloring = localBest.coloring;
+    }
+    MPI_Bcast(groupBest.coloring.data(), g.orig_n, MPI_INT, globalPair.rank, comm);
+    return groupBest;
+}
+
+/**
+ * @brief The subproblems of the largest component, shared by every process.
+ *
+ * The search tree of the component is split at a fixed depth (see subproblemAt()). A
+ * window on process 0 holds the number of the next unclaimed subproblem and the fewest
+ * colors found so far; processes claim subproblems with MPI_Fetch_and_op, as the batch
+ * mode does, so the processes that run out of components keep claiming until none is left.
+ * The fewest colors are also exchanged during the search (see helpSharedComponent()).
+ */
+class SharedComponent {
+public:
+    /**
+     * @param component_ Index of the component (collective over MPI_COMM_WORLD).
+     * @param splitDepth_ Depth of the split.
+     */
+    SharedComponent(int component_, int splitDepth_)
+        : component(component_), splitDepth(splitDepth_), numTasks(1LL << splitDepth_) {
+        int rank, threadLevel;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        MPI_Query_thread(&threadLevel);
+        anyThread = threadLevel >= MPI_THREAD_SERIALIZED;
+        MPI_Win_allocate(rank == 0 ? 2 * sizeof(long long) : 0, sizeof(long long), MPI_INFO_NULL,
+                         MPI_COMM_WORLD, &values, &window);
+        if (rank == 0) {
+            values[0] = 0;
+            values[1] = INF;
+        }
+        MPI_Barrier(MPI_COMM_WORLD);
+    }
+    ~SharedComponent() { MPI_Win_free(&window); }
+    SharedComponent(const SharedComponent &) = delete;
+    SharedComponent &operator=(const SharedComponent &) = delete;
+
+    /**
+     * @brief Claims the next subproblem and exchanges the number of colors.
+     * @param colors Colors of the best coloring of this process.
+     * @param sharedColors Output: the fewest colors found by any process.
+     * @return Number of the subproblem (numTasks or more once all are claimed).
+     */
+    long long claim(int colors, int &sharedColors) {
+        const long long one = 1, mine = colors;
+        long long index, fewest;
+        #pragma omp critical(mpi)
+        {
+            MPI_Win_lock(MPI_LOCK_SHARED, 0, 0, window);
+            MPI_Fetch_and_op(&one, &index, MPI_LONG_LONG, 0, 0, MPI_SUM, window);
+            MPI_Fetch_and_op(&mine, &fewest, MPI_LONG_LONG, 0, 1, MPI_MIN, window);
+            MPI_Win_unlock(0, window);
+        }
+        sharedColors = static_cast<int>(std::min(fewest, mine));
+        return index;
+    }
+
+    /**
+     * @brief Exchanges the number of colors (from a search thread, one at a time).
+     * @param colors Colors of the best coloring of this process.
+     * @return The fewest colors found by any process.
+     */
+    int exchange(int colors) {
+        const long long mine = colors;
+        long long fewest;
+        #pragma omp critical(mpi)
+        {
+            MPI_Win_lock(MPI_LOCK_SHARED, 0, 0, window);
+            MPI_Fetch_and_op(&mine, &fewest, MPI_LONG_LONG, 0, 1, MPI_MIN, window);
+            MPI_Win_unlock(0, window);
+        }
+        return static_cast<int>(std::min(fewest, mine));
+    }
+
+    const int component;      ///< Index of the component.
+    const int splitDepth;     ///< Depth of the split.
+    const long long numTasks; ///< Number of subproblems.
+    bool anyThread;           ///< MPI may be called from any thread (one at a time).
+
+private:
+    long long *values;
+    MPI_Win window;
+};
+
+/**
+ * @brief Searches subproblems of the shared component until every one is claimed.
+ *
+ * The search is pruned against the fewest colors found by any process, which is
+ * exchanged at every claim and every STOP_POLL_INTERVAL nodes; a coloring is kept only
+ * if it improves on the coloring of this process.
+ *
+ * @param g The component graph.
+ * @param shared The shared subproblems.
+ * @param ctx The search context of this process.
+ * @param found Best coloring of the component found by this process (updated; its
+ *        coloring is empty if it has none).
+ * @return False if a subproblem was cut by the time limit.
+ */
+static bool helpSharedComponent(const Graph &g, SharedComponent &shared, SearchContext &ctx,
+                                ColoringSolution &found) {
+    std::function<bool(long long)> stopRequested = ctx.stopRequested;
+    ctx.stopRequested = [&](long long explored) {
+        if (explored % STOP_POLL_INTERVAL == 0 && (shared.anyThread || omp_get_thread_num() == 0)) {
+            int own = ctx.incumbentColors;
+            ctx.sharedColors = shared.exchange(own > 0 ? own : INF);
+        }
+        return stopRequested && stopRequested(explored);
+    };
+    bool completed = true;
+    int sharedColors;
+    for (long long i = shared.claim(found.numColors, sharedColors); i < shared.numTasks;
+         i = shared.claim(found.numColors, sharedColors)) {
+        ctx.sharedColors = sharedColors;
+        if (searchStopped()) {
+            break;
+        }
+        if (ctx.timeUp()) {
+            ctx.completed = false;
+            completed = false;
+            break;
+        }
+        Graph task;
+        if (!subproblemAt(g, shared.splitDepth, i, task)) {
+            continue;
+        }
+        ColoringSolution taskBest;
+        taskBest.numColors = found.numColors;
+        ctx.incumbentColors = found.coloring.empty() ? 0 : found.numColors;
+        if (ctx.decisionColors > 0) {
+            taskBest.numColors = std::min(taskBest.numColors, ctx.decisionColors + 1);
+        }
+        bool completedBefore = ctx.completed;
+        ctx.completed = true;
+        TraceSpan span("subproblem", "index", i);
+        searchComponent(task, taskBest, ctx);
+        completed = completed && ctx.completed;
+        ctx.completed = completedBefore && ctx.completed;
+        if (!taskBest.coloring.empty() && taskBest.numColors < found.numColors) {
+            found = std::move(taskBest);
+        }
+    }
+    ctx.stopRequested = stopRequested;
+    ctx.sharedColors = 0;
+    return completed;
+}
  
  /**
   * @brief Main function that orchestrates the graph coloring process.
@@ -62,21 +335,25 @@
   *             - argv[0]: Program name.
   *             - argv[1]: Path to the input graph file (.col format).
   *             - argv[2]: Time limit (in seconds) for the branch-and-bound search.
+  *             - argv[3..]: Optional flags (see the file documentation).
   *
   * @return int Returns 0 if execution is successful, or a non-zero value if an error occurs.
   *
   * @warning Ensure that the input file exists and that the time limit is a positive number.
   */
 int main(int argc, char** argv) {
-    // Initialize the MPI environment.
-    MPI_Init(&argc, &argv);
+    // Initialize the MPI environment. The stop messages of the decision mode are polled
+    // from the search threads, one at a time.
+    int threadLevel;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_SERIALIZED, &threadLevel);
 
     int mpiRank, mpiSize;
     MPI_Comm_rank(MPI_COMM_WORLD, &mpiRank);
     MPI_Comm_size(MPI_COMM_WORLD, &mpiSize);
+    initStopSignal(threadLevel >= MPI_THREAD_SERIALIZED);
 
-    // Start the wall-clock timer.
-    startTime = steady_clock::now();
+    // Start the wall-clock timer: the search context records its creation time.
+    SearchContext search;
 
     // Attempt to read the OMP_NUM_THREADS environment variable.
     const char* envThreads = std::getenv("OMP_NUM_THREADS");
@@ -91,7 +368,12 @@ int main(int argc, char** argv) {
     // Validate command-line arguments.
     if (argc < 3) {
         if (mpiRank == 0) {
-            std::cerr << "Usage: " << argv[0] << " <input_file> <time_limit_sec>\n";
+            std::cerr << "Usage: " << argv[0] << " <input_file> <time_limit_sec>"
+                      << " [--deterministic] [--seed <n>] [--lp-depth <d>]"
+                      << " [--strategy dfs|best-bound|hybrid|lds] [--queue-memory-mb <n>]"
+                      << " [--memory-limit-mb <n>]"
+                      << " [--decision <k>] [--init-coloring <file>] [--lower-bound <b>] [--batch]"
+                      << " [--perf-counters] [--trace] [--progress <sec>]\n";
         }
         MPI_Finalize();
         return 1;
@@ -99,6 +381,69 @@ int main(int argc, char** argv) {
 
     std::string inputFile = argv[1];
     double timeLimit = atof(argv[2]);
+    search.timeLimit = timeLimit;
+
+    // Parse the optional flags.
+    std::string initColoringFile;
+    int knownLowerBound = 0;
+    bool batchMode = false;
+    bool traceMode = false;
+    double progressInterval = 0;
+    for (int i = 3; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--deterministic") {
+            search.deterministicMode = true;
+        } else if (arg == "--seed" && i + 1 < argc) {
+            search.randomSeed = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--lp-depth" && i + 1 < argc) {
+            search.lpBoundDepth = std::atoi(argv[++i]);
+        } else if (arg == "--strategy" && i + 1 < argc && parseSearchStrategy(argv[i + 1], search.searchStrategy)) {
+            i++;
+        } else if (arg == "--queue-memory-mb" && i + 1 < argc) {
+            search.openNodeMemoryLimit = std::atoll(argv[++i]) << 20;
+        } else if (arg == "--memory-limit-mb" && i + 1 < argc && std::atoll(argv[i + 1]) > 0) {
+            search.memoryLimit = std::atoll(argv[++i]) << 20;
+        } else if (arg == "--decision" && i + 1 < argc && std::atoi(argv[i + 1]) > 0) {
+            search.decisionColors = std::atoi(argv[++i]);
+        } else if (arg == "--init-coloring" && i + 1 < argc) {
+            initColoringFile = argv[++i];
+        } else if (arg == "--lower-bound" && i + 1 < argc && std::atoi(argv[i + 1]) > 0) {
+            knownLowerBound = std::atoi(argv[++i]);
+        } else if (arg == "--batch") {
+            batchMode = true;
+        } else if (arg == "--perf-counters") {
+            enablePerfCounters();
+        } else if (arg == "--trace") {
+            traceMode = true;
+        } else if (arg == "--progress" && i + 1 < argc && std::atof(argv[i + 1]) > 0) {
+            progressInterval = std::atof(argv[++i]);
+        } else {
+            if (mpiRank == 0) {
+                std::cerr << "Unknown option " << arg << std::endl;
+            }
+            MPI_Finalize();
+            return 1;
+        }
+    }
+
+    // In decision mode the search polls for the stop messages of the other processes and
+    // tells its peers as soon as it finds a k-coloring. The progress report is polled at
+    // the same interval.
+    if (search.decisionColors > 0 || progressInterval > 0) {
+        const bool decision = search.decisionColors > 0;
+        search.stopRequested = [decision, &search](long long explored) {
+            if (explored % STOP_POLL_INTERVAL == 0) {
+                if (decision) {
+                    pollStopSignal();
+                }
+                pollProgress(search);
+            }
+            return searchStopped();
+        };
+    }
+    if (search.decisionColors > 0) {
+        search.onDecided = announceComponentDecided;
+    }
 
     // Extract the base name (without directory or extension) from the input file path.
     auto getBaseName = [&](const std::string &fileName) -> std::string {
@@ -109,6 +454,35 @@ int main(int argc, char** argv) {
     };
     std::string baseName = getBaseName(inputFile);
 
+    // Batch mode: every graph of the input file is solved on its own by one thread.
+    if (batchMode) {
+        if (search.decisionColors > 0 || !initColoringFile.empty() || knownLowerBound > 0 || perfCountersEnabled() || traceMode ||
+            progressInterval > 0) {
+            if (mpiRank == 0) {
+                std::cerr << "--decision, --init-coloring, --lower-bound, --perf-counters, --trace and --progress"
+                          << " are not supported with --batch" << std::endl;
+            }
+            MPI_Finalize();
+            return 1;
+        }
+        SolveOptions options;
+        options.timeLimit = timeLimit;
+        options.deterministic = search.deterministicMode;
+        options.seed = search.randomSeed;
+        options.lpBoundDepth = search.lpBoundDepth;
+        options.strategy = search.searchStrategy;
+        options.openNodeMemoryLimit = search.openNodeMemoryLimit;
+        options.memoryLimit = search.memoryLimit;
+        std::ostringstream cmdLine;
+        for (int i = 0; i < argc; i++) {
+            cmdLine << argv[i] << " ";
+        }
+        std::string outputFileName = "../build/output/" + baseName + "_" + std::to_string(mpiSize) + "_batch.output";
+        int status = runBatch(inputFile, outputFileName, options, cmdLine.str());
+        MPI_Finalize();
+        return status;
+    }
+
     // Open a log file specific to this MPI process to record progress.
     {
         std::ostringstream logFileName;
@@ -119,6 +493,16 @@ int main(int argc, char** argv) {
             MPI_Finalize();
             return 1;
         }
+        search.log = &logStream;
+    }
+
+    // The trace clocks of all ranks start together.
+    if (traceMode) {
+        MPI_Barrier(MPI_COMM_WORLD);
+        enableTracing();
+    }
+    if (progressInterval > 0) {
+        initProgress(progressInterval, std::cout);
     }
 
     // Read the full graph from the input file.
@@ -126,87 +510,375 @@ int main(int argc, char** argv) {
     // Identify connected components within the graph.
     std::vector<std::vector<int>> components = findConnectedComponents(fullGraph);
 
-    // Global variables to store the final coloring solution.
-    std::vector<int> globalColoring(fullGraph.orig_n, -1);
+    // Read and validate the warm start: the initial coloring must be proper and complete,
+    // and the known lower bound may not exceed its number of colors.
+    std::vector<int> initialColoring;
+    int initialColors = 0;
+    if (!initColoringFile.empty()) {
+        initialColoring = readColoringFromFile(initColoringFile, fullGraph.orig_n);
+        if (!isProperColoring(fullGraph, initialColoring)) {
+            if (mpiRank == 0) {
+                std::cerr << "Invalid initial coloring " << initColoringFile << std::endl;
+            }
+            MPI_Finalize();
+            return 1;
+        }
+        initialColors = static_cast<int>(std::set<int>(initialColoring.begin(), initialColoring.end()).size());
+    }
+    if (!initialColoring.empty() && knownLowerBound > initialColors) {
+        if (mpiRank == 0) {
+            std::cerr << "Lower bound " << knownLowerBound << " exceeds the " << initialColors
+                      << " colors of the initial coloring" << std::endl;
+        }
+        MPI_Finalize();
+        return 1;
+    }
+
+    // Global variables to store the final coloring solution (only held by the root process).
+    std::vector<int> globalColoring;
+    if (mpiRank == 0) {
+        globalColoring.assign(fullGraph.orig_n, -1);
+    }
     int globalBestColors = INF;
 
-    // Process each connected component separately if more than one exists.
-    if (components.size() > 1) {
-        int localBestColors = 0;
-        std::vector<int> localColoring(fullGraph.orig_n, -1);
-
-        // Distribute connected components among MPI processes.
-        for (size_t i = 0; i < components.size(); i++) {
-            if (static_cast<int>(i % mpiSize) == mpiRank) {
-                // Extract the subgraph corresponding to the current component.
-                Graph subG = extractSubgraph(fullGraph, components[i]);
-                ColoringSolution compBest;
-                #pragma omp parallel
-                {
-                    #pragma omp single nowait
-                    {
-                        branchAndBound(subG, compBest, timeLimit, 0);
-                    }
-                }
-                localBestColors = std::max(localBestColors, compBest.numColors);
-                for (int v : components[i]) {
-                    localColoring[v] = compBest.coloring[v];
-                }
-            }
+    // Classify the components: trivial ones (singletons, cliques, bipartite graphs) are
+    // colored directly by the root process, the others are scheduled for search.
+    int localBestColors = 0;
+    int localLowerBound = knownLowerBound;
+    std::vector<int> localAssignments;  // Flattened (vertex, color) pairs of the owned components.
+    std::vector<ComponentInfo> searchComponents;
+    std::vector<ComponentInfo> infos(components.size());
+    #pragma omp parallel for schedule(dynamic)
+    for (size_t i = 0; i < components.size(); i++) {
+        infos[i] = classifyComponent(fullGraph, components[i], static_cast<int>(i));
+    }
+    for (size_t i = 0; i < components.size(); i++) {
+        const ComponentInfo &info = infos[i];
+        localLowerBound = std::max(localLowerBound, info.lowerBound);
+        if (info.kind == ComponentKind::General) {
+            searchComponents.push_back(info);
+        } else if (mpiRank == 0) {
+            int colors = colorTrivialComponent(fullGraph, components[i], info.kind, globalColoring);
+            localBestColors = std::max(localBestColors, colors);
         }
-        // Reduce the results from all MPI processes.
-        MPI_Reduce(&localBestColors, &globalBestColors, 1, MPI_INT, MPI_MAX, 0, MPI_COMM_WORLD);
-        MPI_Reduce(localColoring.data(), globalColoring.data(), fullGraph.orig_n, MPI_INT,
-                MPI_MAX, 0, MPI_COMM_WORLD);
     }
-    else {
-        // For a single connected component, perform static task decomposition.
-        Graph subG = extractSubgraph(fullGraph, components[0]);
-        std::vector<Graph> tasks;
-        ColoringSolution dummy;
-        dummy.numColors = INF;
+    std::vector<ComponentAssignment> schedule = scheduleComponents(searchComponents, mpiSize);
 
-        // Decompose the search tree into smaller subproblems.
-        decomposeBnb(subG, 0, 2, tasks, timeLimit, dummy);
-        if (tasks.empty()) {
-            tasks.push_back(subG);
+    // Ranks sharing a component form a communicator; a rank belongs to at most one such group.
+    int groupColor = MPI_UNDEFINED;
+    for (size_t k = 0; k < schedule.size(); k++) {
+        const ComponentAssignment &a = schedule[k];
+        if (a.numRanks > 1 && mpiRank >= a.firstRank && mpiRank < a.firstRank + a.numRanks) {
+            groupColor = static_cast<int>(k);
         }
+    }
+    MPI_Comm groupComm;
+    MPI_Comm_split(MPI_COMM_WORLD, groupColor, mpiRank, &groupComm);
 
-        ColoringSolution localBest;
-        #pragma omp parallel
-        {
-            #pragma omp single nowait
-            {
-                for (size_t i = 0; i < tasks.size(); i++) {
-                    if (static_cast<int>(i % mpiSize) == mpiRank) {
-                        #pragma omp task firstprivate(i)
-                        {
-                            branchAndBound(tasks[i], localBest, timeLimit, 2);
-                        }
-                    }
-                }
-                #pragma omp taskwait
+    // Extract the assigned components.
+    std::vector<ComponentAssignment> assigned;
+    std::vector<int> assignedIndices;
+    for (const ComponentAssignment &a : schedule) {
+        if (mpiRank >= a.firstRank && mpiRank < a.firstRank + a.numRanks) {
+            assigned.push_back(a);
+            assignedIndices.push_back(a.component);
+        }
+    }
+    std::vector<Graph> assignedGraphs = extractSubgraphs(fullGraph, components, assignedIndices);
+
+    // Color the assigned components with the root heuristic portfolio, which uses all
+    // threads per component (a different variant per process).
+    std::vector<PortfolioResult> portfolios;
+    for (size_t k = 0; k < assignedGraphs.size(); k++) {
+        TraceSpan span("portfolio", "component", assigned[k].component);
+        portfolios.push_back(portfolioColoring(assignedGraphs[k], search, static_cast<unsigned int>(mpiRank)));
+        logStream << "Portfolio: component " << assigned[k].component << ", " << portfolios[k].numColors
+                  << " colors by " << portfolioHeuristics()[portfolios[k].heuristic]
+                  << " (" << portfolios[k].runs << " runs)" << std::endl;
+        // The initial coloring replaces the portfolio coloring unless it is worse.
+        if (!initialColoring.empty()) {
+            std::pair<int, std::vector<int>> warm = restrictColoring(assignedGraphs[k], initialColoring);
+            if (warm.first <= portfolios[k].numColors) {
+                portfolios[k].numColors = warm.first;
+                portfolios[k].coloring = std::move(warm.second);
+                logStream << "Initial coloring: component " << assigned[k].component << ", "
+                          << warm.first << " colors" << std::endl;
             }
         }
+    }
 
-        int localBestValue = localBest.numColors;
-        int globalBestValue;
-        MPI_Allreduce(&localBestValue, &globalBestValue, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+    // Tighten the lower bound with the root-node lower-bound pipeline of each component.
+    #pragma omp parallel for schedule(dynamic) reduction(max:localLowerBound)
+    for (size_t k = 0; k < assignedGraphs.size(); k++) {
+        const Graph &subG = assignedGraphs[k];
+        BoundContext bounds(subG, 0, portfolios[k].numColors, portfolios[k].coloring, search.lpBoundDepth);
+        evaluateLowerBounds(bounds);
+        localLowerBound = std::max(localLowerBound, bounds.lowerBound);
+    }
+
+    // The chromatic number of the graph is the maximum over its components, so every
+    // component search can stop as soon as it reaches the global lower bound.
+    int globalLowerBound = 0;
+    MPI_Allreduce(&localLowerBound, &globalLowerBound, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    search.colorTarget = globalLowerBound;
+
+    // In decision mode every search stops at the first k-coloring, and a lower bound
+    // above k already answers no.
+    bool provenNotColorable = false;
+    const int decisionColors = search.decisionColors;
+    if (decisionColors > 0) {
+        search.colorTarget = decisionColors;
+        provenNotColorable = globalLowerBound > decisionColors;
+    }
+
+    // The progress report counts the components not being searched into the upper bound:
+    // the finished ones and those still waiting for their search (from their portfolio).
+    auto reportBounds = [&](size_t next) {
+        int lowerBound = std::max(globalLowerBound, decisionColors > 0 ? 0 : search.colorTarget.load());
+        int upperBound = localBestColors;
+        for (size_t j = next; j < portfolios.size(); j++) {
+            upperBound = std::max(upperBound, portfolios[j].numColors);
+        }
+        setProgressBounds(lowerBound, upperBound);
+    };
+
+    // Processes that run out of components help on the largest one: its subproblems are
+    // claimed through a shared counter by its own processes and, once they are done with
+    // their components, by all the others. Deterministic runs, and schedules that already
+    // give every process to the largest component, keep the static assignment.
+    std::unique_ptr<SharedComponent> shared;
+    Graph sharedGraph;
+    ColoringSolution sharedFound;  // Best coloring of the shared component found by this process.
+    bool sharedCompleted = true;
+    std::vector<int> allPeers;
+    if (!schedule.empty() && schedule[0].numRanks < mpiSize && !search.deterministicMode) {
+        int splitDepth = 0;
+        while (splitDepth < MAX_HELP_SPLIT_DEPTH && (1LL << splitDepth) < static_cast<long long>(HELP_TASKS_PER_RANK) * mpiSize) {
+            splitDepth++;
+        }
+        shared.reset(new SharedComponent(schedule[0].component, splitDepth));
+        sharedGraph = extractSubgraphs(fullGraph, components, {schedule[0].component})[0];
+        for (int r = 0; r < mpiSize; r++) {
+            if (r != mpiRank) allPeers.push_back(r);
+        }
+    }
+    auto isShared = [&](int component) { return shared && component == shared->component; };
+
+    // Solve the assigned components, largest first.
+    for (size_t k = 0; k < assigned.size(); k++) {
+        const ComponentAssignment &a = assigned[k];
+        const Graph &subG = assignedGraphs[k];
+        reportBounds(k + 1);
+        search.incumbentColors = portfolios[k].numColors;
+        pollProgress(search);
+        // The portfolio coloring is the initial incumbent.
+        ColoringSolution compBest;
+        compBest.numColors = portfolios[k].numColors;
+        compBest.coloring = subG.expandColoring(portfolios[k].coloring);
+        ColoringSolution portfolioBest = compBest;
+        // In decision mode the search starts from the incumbent k + 1, so that every node
+        // with a lower bound above k is pruned.
+        if (decisionColors > 0) {
+            compBest.numColors = std::min(compBest.numColors, decisionColors + 1);
+        }
+        // Every process may help on the shared component, so its stop messages go to all.
+        std::vector<int> peers;
+        for (int r = a.firstRank; r < a.firstRank + a.numRanks; r++) {
+            if (r != mpiRank) peers.push_back(r);
+        }
+        beginComponentSearch(a.component, isShared(a.component) ? allPeers : peers);
+        TraceSpan span("component", "component", a.component);
+        if (decisionColors > 0 && compBest.numColors <= decisionColors) {
+            announceComponentDecided();  // The portfolio already answers yes for this component.
+        }
+        bool componentCompleted = true;
+        if (isShared(a.component)) {
+            sharedFound = portfolioBest;
+        }
+        if (provenNotColorable) {
+            // Nothing to search: the answer is already known.
+        } else if (isShared(a.component)) {
+            sharedCompleted = helpSharedComponent(subG, *shared, search, sharedFound);
+        } else if (a.numRanks > 1) {
+            compBest = solveOnCommunicator(subG, groupComm, search, compBest, componentCompleted);
+        } else {
+            searchComponent(subG, compBest, search);
+            componentCompleted = search.completed;
+        }
+        bool stopped = searchStopped();
+        endComponentSearch();
+        if (isShared(a.component)) {
+            continue;  // Combined with the results of the helpers below.
+        }
+        if (a.numRanks > 1 && mpiRank != a.firstRank) {
+            continue;  // Only the group leader contributes the result.
+        }
+        if (decisionColors > 0 && compBest.numColors > decisionColors) {
+            // A complete search without a k-coloring answers no for the whole graph.
+            if (!provenNotColorable && componentCompleted && !stopped) {
+                provenNotColorable = true;
+                announceStopAll();
+            }
+            compBest = portfolioBest;  // The incumbent k + 1 has no coloring of its own.
+        }
+        // A component solved to optimality raises the bound for the remaining ones.
+        if (componentCompleted) {
+            search.colorTarget = std::max(search.colorTarget.load(), compBest.numColors);
+        }
+        localBestColors = std::max(localBestColors, compBest.numColors);
+        for (int v : components[a.component]) {
+            localAssignments.push_back(v);
+            localAssignments.push_back(compBest.coloring[v]);
+        }
+    }
+    if (groupComm != MPI_COMM_NULL) {
+        MPI_Comm_free(&groupComm);
+    }
 
-        // Determine the MPI process with the best solution.
+    // The other processes help on the shared component; the process with the fewest colors
+    // then contributes its coloring. Without a k-coloring, the component answers no once
+    // every subproblem was searched to the end.
+    if (shared) {
+        const ComponentAssignment &a = schedule[0];
+        if (!provenNotColorable && (mpiRank < a.firstRank || mpiRank >= a.firstRank + a.numRanks)) {
+            beginComponentSearch(a.component, allPeers);
+            TraceSpan span("help", "component", a.component);
+            sharedCompleted = helpSharedComponent(sharedGraph, *shared, search, sharedFound);
+            endComponentSearch();
+        }
         struct { int value; int rank; } localPair, globalPair;
-        localPair.value = localBestValue;
-        localPair.rank  = mpiRank;
+        localPair.value = sharedFound.coloring.empty() ? INF : sharedFound.numColors;
+        localPair.rank = mpiRank;
         MPI_Allreduce(&localPair, &globalPair, 1, MPI_2INT, MPI_MINLOC, MPI_COMM_WORLD);
+        int localDone = sharedCompleted ? 1 : 0;
+        int allDone = 0;
+        MPI_Allreduce(&localDone, &allDone, 1, MPI_INT, MPI_LAND, MPI_COMM_WORLD);
+        if (mpiRank == globalPair.rank) {
+            if (decisionColors > 0 && globalPair.value > decisionColors && allDone) {
+                provenNotColorable = true;
+            }
+            localBestColors = std::max(localBestColors, sharedFound.numColors);
+            for (int v : components[a.component]) {
+                localAssignments.push_back(v);
+                localAssignments.push_back(sharedFound.coloring[v]);
+            }
+        }
+        shared.reset();
+    }
+    reportBounds(assigned.size());
+    finishProgress(search);
+    finishStopSignal();
 
-        globalBestColors = globalBestValue;
-        globalColoring.assign(fullGraph.orig_n, -1);
+    // Reduce the results from all MPI processes.
+    MPI_Reduce(&localBestColors, &globalBestColors, 1, MPI_INT, MPI_MAX, 0, MPI_COMM_WORLD);
 
-        // Broadcast the best coloring solution from the process that found it.
-        if (mpiRank == globalPair.rank) {
-            globalColoring = localBest.coloring;
+    // Gather only the (vertex, color) pairs of the owned components on the root process.
+    int localCount = static_cast<int>(localAssignments.size());
+    std::vector<int> counts(mpiSize, 0), displs(mpiSize, 0);
+    MPI_Gather(&localCount, 1, MPI_INT, counts.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+    std::vector<int> allAssignments;
+    if (mpiRank == 0) {
+        for (int r = 1; r < mpiSize; r++) {
+            displs[r] = displs[r - 1] + counts[r - 1];
+        }
+        allAssignments.resize(displs[mpiSize - 1] + counts[mpiSize - 1]);
+    }
+    MPI_Gatherv(localAssignments.data(), localCount, MPI_INT, allAssignments.data(),
+                counts.data(), displs.data(), MPI_INT, 0, MPI_COMM_WORLD);
+    for (size_t k = 0; k + 1 < allAssignments.size(); k += 2) {
+        globalColoring[allAssignments[k]] = allAssignments[k + 1];
+    }
+
+    // The search is complete only if every process finished within the time limit.
+    int localCompleted = search.completed ? 1 : 0;
+    int globalCompleted = 0;
+    MPI_Allreduce(&localCompleted, &globalCompleted, 1, MPI_INT, MPI_LAND, MPI_COMM_WORLD);
+    bool searchCompleted = (globalCompleted != 0);
+
+    // In decision mode the answer is no if any process proved a component not k-colorable
+    // and yes if the coloring uses at most k colors. The answer goes to decision_result
+    // only: is_within_time_limit still reports whether every search finished in time.
+    int localNo = (provenNotColorable || stopAllReceived()) ? 1 : 0;
+    int globalNo = 0;
+    MPI_Allreduce(&localNo, &globalNo, 1, MPI_INT, MPI_LOR, MPI_COMM_WORLD);
+    const char *decisionResult = "unknown";
+    if (decisionColors > 0 && mpiRank == 0) {
+        if (globalNo) {
+            decisionResult = "no";
+        } else if (globalBestColors <= decisionColors) {
+            decisionResult = "yes";
+        }
+    }
+
+    // Sum the explored node counts over all MPI processes.
+    long long localNodes = search.nodesExplored.load();
+    long long totalNodes = 0;
+    MPI_Reduce(&localNodes, &totalNodes, 1, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+
+    // Largest open-node queue of any MPI process.
+    long long localPeak = search.openNodesPeak.load();
+    long long maxPeak = 0;
+    MPI_Reduce(&localPeak, &maxPeak, 1, MPI_LONG_LONG, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    // Largest graph memory peaks of any MPI process; memory-limited nodes summed.
+    long long localMemory[2] = {search.graphMemory.peak.load(), search.taskMemory.peak.load()};
+    long long maxMemory[2] = {0, 0};
+    MPI_Reduce(localMemory, maxMemory, 2, MPI_LONG_LONG, MPI_MAX, 0, MPI_COMM_WORLD);
+    long long localLimited = search.memoryLimitedNodes.load();
+    long long totalLimited = 0;
+    MPI_Reduce(&localLimited, &totalLimited, 1, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+
+    // Sum the arena statistics (scratch bytes and heap allocations) over all MPI processes.
+    long long localArena[2] = {search.arenaBytes.load(), arenaChunkAllocations.load()};
+    long long totalArena[2] = {0, 0};
+    MPI_Reduce(localArena, totalArena, 2, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+
+    // Sum the per-bound prune counts over all MPI processes.
+    const std::vector<LowerBoundRule> &boundRules = lowerBoundPipeline();
+    std::vector<long long> localPrunes(boundRules.size()), totalPrunes(boundRules.size());
+    for (size_t r = 0; r < boundRules.size(); r++)
+        localPrunes[r] = search.boundPrunes[r].load();
+    MPI_Reduce(localPrunes.data(), totalPrunes.data(), static_cast<int>(boundRules.size()), MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+
+    // Sum the portfolio wins per heuristic over all MPI processes.
+    const std::vector<const char *> &heuristics = portfolioHeuristics();
+    std::vector<long long> localWins(heuristics.size()), totalWins(heuristics.size());
+    for (size_t h = 0; h < heuristics.size(); h++)
+        localWins[h] = search.portfolioWins[h].load();
+    MPI_Reduce(localWins.data(), totalWins.data(), static_cast<int>(heuristics.size()), MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+
+    // Sum the performance counters (calls and events per phase) over all MPI processes.
+    const std::vector<const char *> &perfPhases = perfPhaseNames();
+    const std::vector<const char *> &perfEvents = perfEventNames();
+    std::vector<long long> totalPerf(perfPhases.size() * PERF_VALUES_PER_PHASE, 0);
+    int perfAvailable = 0;
+    if (perfCountersEnabled()) {
+        std::vector<long long> localPerf = perfCounterTotals();
+        MPI_Reduce(localPerf.data(), totalPerf.data(), static_cast<int>(localPerf.size()), MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+        int localAvailable = 0;
+        for (int e = 0; e < PERF_NUM_EVENTS; e++)
+            localAvailable |= perfEventAvailable(e) << e;
+        MPI_Reduce(&localAvailable, &perfAvailable, 1, MPI_INT, MPI_BOR, 0, MPI_COMM_WORLD);
+    }
+
+    // Gather the trace events of all MPI processes on the root process, rank by rank.
+    std::string traceJson;
+    long long traceDropped = 0;
+    if (traceMode) {
+        std::string localTrace = (mpiRank > 0 ? ",\n" : "") + traceEventsJson(mpiRank);
+        int localLength = static_cast<int>(localTrace.size());
+        std::vector<int> traceCounts(mpiSize, 0), traceDispls(mpiSize, 0);
+        MPI_Gather(&localLength, 1, MPI_INT, traceCounts.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+        if (mpiRank == 0) {
+            for (int r = 1; r < mpiSize; r++) {
+                traceDispls[r] = traceDispls[r - 1] + traceCounts[r - 1];
+            }
+            traceJson.resize(traceDispls[mpiSize - 1] + traceCounts[mpiSize - 1]);
         }
-        MPI_Bcast(globalColoring.data(), fullGraph.orig_n, MPI_INT, globalPair.rank, MPI_COMM_WORLD);
+        MPI_Gatherv(localTrace.data(), localLength, MPI_CHAR, &traceJson[0], traceCounts.data(),
+                    traceDispls.data(), MPI_CHAR, 0, MPI_COMM_WORLD);
+        long long localDropped = traceDroppedEvents();
+        MPI_Reduce(&localDropped, &traceDropped, 1, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
     }
 
     MPI_Barrier(MPI_COMM_WORLD);
@@ -216,11 +888,7 @@ int main(int argc, char** argv) {
 
     // The root process writes the final results to an output file.
     if (mpiRank == 0) {
-        int edgeCount = 0;
-        for (int i = 0; i < fullGraph.n; i++) {
-            edgeCount += fullGraph.adj[i].size();
-        }
-        edgeCount /= 2;
+        long long edgeCount = fullGraph.numEdges();
 
         std::ostringstream cmdLine;
         for (int i = 0; i < argc; i++) {
@@ -237,7 +905,7 @@ int main(int argc, char** argv) {
             return 1;
         }
 
-        double wallTime = duration_cast<duration<double>>(steady_clock::now() - startTime).count();
+        double wallTime = search.elapsed();
 
         // Write detailed information about the instance and solution.
         outFile << "problem_instance_file_name: " << baseName << "\n";
@@ -251,6 +919,71 @@ int main(int argc, char** argv) {
         outFile << "wall_time_sec: " << wallTime << "\n";
         outFile << "is_within_time_limit: " << (searchCompleted ? "true" : "false") << "\n";
         outFile << "number_of_colors: " << globalBestColors << "\n";
+        outFile << "number_of_nodes: " << totalNodes << "\n";
+        outFile << "arena_bytes_per_node: " << (totalNodes > 0 ? totalArena[0] / totalNodes : 0) << "\n";
+        outFile << "arena_heap_allocations: " << totalArena[1] << "\n";
+        outFile << "simd_level: " << simdLevelName() << "\n";
+        outFile << "deterministic_mode: " << (search.deterministicMode ? "true" : "false") << "\n";
+        outFile << "random_seed: " << search.randomSeed << "\n";
+        outFile << "lp_bound_depth: " << search.lpBoundDepth << "\n";
+        outFile << "search_strategy: " << searchStrategyName(search.searchStrategy) << "\n";
+        if (!initialColoring.empty()) {
+            outFile << "initial_colors: " << initialColors << "\n";
+        }
+        if (knownLowerBound > 0) {
+            outFile << "initial_lower_bound: " << knownLowerBound << "\n";
+        }
+        if (decisionColors > 0) {
+            outFile << "decision_colors: " << decisionColors << "\n";
+            outFile << "decision_result: " << decisionResult << "\n";
+        }
+        outFile << "open_nodes_peak: " << maxPeak << "\n";
+        outFile << "graph_memory_peak_bytes: " << maxMemory[0] << "\n";
+        outFile << "task_memory_peak_bytes: " << maxMemory[1] << "\n";
+        if (search.memoryLimit > 0) {
+            outFile << "memory_limit_mb: " << (search.memoryLimit >> 20) << "\n";
+            outFile << "memory_limited_nodes: " << totalLimited << "\n";
+        }
+        for (size_t r = 0; r < boundRules.size(); r++)
+            outFile << "pruned_by_" << boundRules[r].name << ": " << totalPrunes[r] << "\n";
+        for (size_t h = 0; h < heuristics.size(); h++)
+            outFile << "portfolio_wins_" << heuristics[h] << ": " << totalWins[h] << "\n";
+        if (perfCountersEnabled()) {
+            auto available = [perfAvailable](int e) { return (perfAvailable >> e) & 1; };
+            auto ratio = [](long long a, long long b) { return b > 0 ? static_cast<double>(a) / b : 0.0; };
+            outFile << "perf_events:";
+            for (int e = 0; e < PERF_NUM_EVENTS; e++)
+                if (available(e)) outFile << " " << perfEvents[e];
+            outFile << (perfAvailable == 0 ? " none\n" : "\n");
+            for (size_t p = 0; p < perfPhases.size(); p++) {
+                const long long *v = &totalPerf[p * PERF_VALUES_PER_PHASE];
+                const long long *count = v + 1;
+                std::string prefix = std::string("perf_") + perfPhases[p] + "_";
+                outFile << prefix << "calls: " << v[0] << "\n";
+                if (available(PERF_TASK_CLOCK))
+                    outFile << prefix << "cpu_ms: " << count[PERF_TASK_CLOCK] / 1e6 << "\n";
+                if (available(PERF_CYCLES) && available(PERF_INSTRUCTIONS)) {
+                    outFile << prefix << "cycles: " << count[PERF_CYCLES] << "\n";
+                    outFile << prefix << "instructions: " << count[PERF_INSTRUCTIONS] << "\n";
+                    outFile << prefix << "ipc: " << ratio(count[PERF_INSTRUCTIONS], count[PERF_CYCLES]) << "\n";
+                }
+                if (available(PERF_CACHE_REFERENCES) && available(PERF_CACHE_MISSES))
+                    outFile << prefix << "cache_miss_rate: " << ratio(count[PERF_CACHE_MISSES], count[PERF_CACHE_REFERENCES]) << "\n";
+                if (available(PERF_BRANCHES) && available(PERF_BRANCH_MISSES))
+                    outFile << prefix << "branch_miss_rate: " << ratio(count[PERF_BRANCH_MISSES], count[PERF_BRANCHES]) << "\n";
+            }
+        }
+
+        if (traceMode) {
+            std::string traceFileName = outputDir + baseName + "_" + std::to_string(mpiSize) + ".trace.json";
+            std::ofstream traceFile(traceFileName);
+            traceFile << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n" << traceJson << "\n]}\n";
+            if (!traceFile) {
+                std::cerr << "Error writing trace file " << traceFileName << std::endl;
+            }
+            outFile << "trace_file: " << traceFileName << "\n";
+            outFile << "trace_dropped_events: " << traceDropped << "\n";
+        }
 
         // Output the final coloring assignment for each vertex.
         for (int i = 0; i < fullGraph.orig_n; i++) {
@@ -0,0 +1,265 @@
+/**
+ * @file node_queue.cpp
+ * @brief Implementation of the open-node queue search engine.
+ */
+
+ #include "node_queue.hpp"
+ #include "branch_and_bound.hpp"
+ #include <omp.h>
+ #include <algorithm>
+ #include <atomic>
+ #include <thread>
+
+ namespace {
+
+ /**
+  * @brief A search node waiting in the queue.
+  */
+ struct OpenNode {
+     Graph g;             ///< The node graph.
+     int depth;           ///< Depth in the search tree.
+     int bound;           ///< Lower bound inherited from the parent.
+     int discrepancies;   ///< Number of addEdge branches on the path from the root.
+     long long sequence;  ///< Insertion number, set by the queue.
+ };
+
+ /**
+  * @brief The open nodes, kept as a binary heap ordered by the search strategy.
+  *
+  * Best-bound selection takes the node with the smallest bound, then the deepest one;
+  * all ties (and the other strategies) go to the node inserted last, which makes the
+  * queue a depth-first stack. The hybrid strategy switches from the stack to best-bound
+  * selection with useBestBound().
+  */
+ class NodeQueue {
+ public:
+     explicit NodeQueue(SearchStrategy strategy) : order{strategy == SearchStrategy::BestBound} {}
+
+     void push(OpenNode node) {
+         node.sequence = nextSequence++;
+         bytes += node.g.memoryBytes();
+         heap.push_back(std::move(node));
+         std::push_heap(heap.begin(), heap.end(), order);
+         peak = std::max(peak, static_cast<long long>(heap.size()));
+     }
+
+     OpenNode pop() {
+         std::pop_heap(heap.begin(), heap.end(), order);
+         OpenNode node = std::move(heap.back());
+         heap.pop_back();
+         bytes -= node.g.memoryBytes();
+         return node;
+     }
+
+     /** @brief Switches to best-bound selection (reorders the heap). */
+     void useBestBound() {
+         if (order.byBound) return;
+         order.byBound = true;
+         std::make_heap(heap.begin(), heap.end(), order);
+     }
+
+     bool empty() const { return heap.empty(); }
+     long long memoryBytes() const { return bytes; }
+     long long peakSize() const { return peak; }
+
+ private:
+     /** @brief True if a is selected after b. */
+     struct SelectedLater {
+         bool byBound;
+         bool operator()(const OpenNode &a, const OpenNode &b) const {
+             if (byBound) {
+                 if (a.bound != b.bound) return a.bound > b.bound;
+                 if (a.depth != b.depth) return a.depth < b.depth;
+             }
+             return a.sequence < b.sequence;
+         }
+     };
+
+     SelectedLater order;
+     vector<OpenNode> heap;
+     long long nextSequence = 0;
+     long long bytes = 0;
+     long long peak = 0;
+ };
+
+ /**
+  * @brief Depth-first search below a node within a discrepancy budget.
+  *
+  * The limited discrepancy search falls back to this when the queue is over its memory
+  * cap: the node is searched without queuing its descendants, and addEdge branches
+  * beyond the budget are cut as in the queue.
+  *
+  * @param g The node graph.
+  * @param bestSolution The best coloring solution found so far (updated).
+  * @param ctx The search context.
+  * @param depth Depth of the node.
+  * @param discrepancies Number of addEdge branches on the path to the node.
+  * @param maxDiscrepancies The discrepancy budget of the iteration.
+  * @return True if a node was cut by the budget.
+  */
+ bool limitedDepthFirst(const Graph &g, ColoringSolution &bestSolution, SearchContext &ctx, int depth,
+                        int discrepancies, int maxDiscrepancies) {
+     NodeEvaluation e = evaluateNode(g, bestSolution, ctx, depth);
+     if (!e.expand) return false;
+     Graph childMerge = g.mergeVertices(e.v1, e.v2);
+     MemoryCharge mergeCharge(ctx.graphMemory, childMerge.memoryBytes());
+     bool truncated = limitedDepthFirst(childMerge, bestSolution, ctx, depth + 1, discrepancies, maxDiscrepancies);
+     if (discrepancies + 1 > maxDiscrepancies) return true;
+     Graph childEdge = g.addEdge(e.v1, e.v2);
+     MemoryCharge edgeCharge(ctx.graphMemory, childEdge.memoryBytes());
+     return limitedDepthFirst(childEdge, bestSolution, ctx, depth + 1, discrepancies + 1, maxDiscrepancies) ||
+            truncated;
+ }
+
+ } // namespace
+
+ /**
+  * @brief Solves a set of subproblems with the open-node queue engine.
+  * @param roots The subproblems.
+  * @param bestSolution The best coloring solution found so far (updated).
+  * @param ctx The search context (time limit, strategy, statistics).
+  * @param depth Depth of the roots in the search tree.
+  */
+ void searchNodeQueue(const vector<Graph> &roots, ColoringSolution &bestSolution, SearchContext &ctx, int depth) {
+     const bool limited = ctx.searchStrategy == SearchStrategy::LimitedDiscrepancy;
+     const bool hybrid = ctx.searchStrategy == SearchStrategy::Hybrid;
+
+     // The limited discrepancy search restarts with one more allowed discrepancy until
+     // an iteration runs without cutting any node; the other strategies run once.
+     for (int maxDiscrepancies = limited ? 0 : INF; ; maxDiscrepancies++) {
+         NodeQueue queue(ctx.searchStrategy);
+         for (const Graph &g : roots) {
+             queue.push({g, depth, 0, 0, 0});
+             ctx.taskMemory.add(g.memoryBytes());
+         }
+         ctx.openTasks += static_cast<long long>(roots.size());
+         int busy = 0;                     // Threads holding a node.
+         bool truncated = false;           // A node was cut by the discrepancy limit.
+         std::atomic<bool> diving(false);  // Hybrid: best-bound dives (after the first improvement).
+         int firstIncumbent = -1;          // Hybrid: incumbent after the first evaluated node.
+
+         #pragma omp parallel num_threads(ctx.deterministicMode ? 1 : ctx.threads())
+         {
+             while (true) {
+                 OpenNode node;
+                 bool have = false, finished = false;
+                 #pragma omp critical(nodeQueue)
+                 {
+                     if (!queue.empty()) {
+                         node = queue.pop();
+                         have = true;
+                         busy++;
+                         ctx.openTasks--;
+                         ctx.taskMemory.add(-node.g.memoryBytes());
+                     } else if (busy == 0) {
+                         finished = true;
+                     }
+                 }
+                 if (finished) break;
+                 if (!have) {
+                     // A thread over the queue cap may have spawned search tasks; run them
+                     // while waiting for nodes (taskyield is a task scheduling point).
+                     #pragma omp taskyield
+                     std::this_thread::yield();
+                     continue;
+                 }
+
+                 // Expand the node. The hybrid strategy runs depth-first until the incumbent
+                 // improves, then dives into the merge child of every best-bound node.
+                 while (true) {
+                     bool overCap;
+                     #pragma omp critical(nodeQueue)
+                     overCap = queue.memoryBytes() > ctx.openNodeMemoryLimit || ctx.memoryNearLimit();
+                     if (overCap) {
+                         // Search the node depth-first instead of queuing its children.
+                         if (!limited) {
+                             branchAndBound(node.g, bestSolution, ctx, node.depth);
+                         } else if (limitedDepthFirst(node.g, bestSolution, ctx, node.depth,
+                                                      node.discrepancies, maxDiscrepancies)) {
+                             #pragma omp critical(nodeQueue)
+                             truncated = true;
+                         }
+                         break;
+                     }
+                     NodeEvaluation e = evaluateNode(node.g, bestSolution, ctx, node.depth);
+                     if (hybrid && !diving) {
+                         bool improved = false;
+                         #pragma omp critical
+                         {
+                             if (firstIncumbent == -1)
+                                 firstIncumbent = bestSolution.numColors;
+                             else
+                                 improved = bestSolution.numColors < firstIncumbent;
+                         }
+                         if (improved) {
+                             #pragma omp critical(nodeQueue)
+                             queue.useBestBound();
+                             diving = true;
+                         }
+                     }
+                     if (!e.expand) break;
+                     bool dive = diving;
+                     OpenNode merge{node.g.mergeVertices(e.v1, e.v2), node.depth + 1, e.lowerBound, node.discrepancies, 0};
+                     OpenNode edge{node.g.addEdge(e.v1, e.v2), node.depth + 1, e.lowerBound, node.discrepancies + 1, 0};
+                     #pragma omp critical(nodeQueue)
+                     {
+                         if (edge.discrepancies <= maxDiscrepancies) {
+                             ctx.taskMemory.add(edge.g.memoryBytes());
+                             queue.push(std::move(edge));
+                             ctx.openTasks++;
+                         } else {
+                             truncated = true;
+                         }
+                         if (!dive) {
+                             ctx.taskMemory.add(merge.g.memoryBytes());
+                             queue.push(std::move(merge));
+                             ctx.openTasks++;
+                         }
+                     }
+                     if (!dive) break;
+                     node = std::move(merge);
+                 }
+                 #pragma omp critical(nodeQueue)
+                 busy--;
+             }
+         }
+
+         if (queue.peakSize() > ctx.openNodesPeak)
+             ctx.openNodesPeak = queue.peakSize();
+         if (!limited || !truncated) break;
+         int incumbent;
+         #pragma omp critical
+         incumbent = bestSolution.numColors;
+         if (ctx.timeUp() || incumbent <= ctx.colorTarget.load()) break;
+     }
+ }
+
+ /**
+  * @brief Parses a strategy name (dfs, best-bound, hybrid, lds).
+  * @param name The name.
+  * @param strategy Output: the strategy.
+  * @return False if the name is unknown.
+  */
+ bool parseSearchStrategy(const string &name, SearchStrategy &strategy) {
+     for (SearchStrategy s : {SearchStrategy::DepthFirst, SearchStrategy::BestBound,
+                              SearchStrategy::Hybrid, SearchStrategy::LimitedDiscrepancy}) {
+         if (name == searchStrategyName(s)) {
+             strategy = s;
+             return true;
+         }
+     }
+     return false;
+ }
+
+ /**
+  * @brief Name of a strategy, as accepted by parseSearchStrategy().
+  */
+ const char *searchStrategyName(SearchStrategy strategy) {
+     switch (strategy) {
+     case SearchStrategy::DepthFirst:         return "dfs";
+     case SearchStrategy::BestBound:          return "best-bound";
+     case SearchStrategy::Hybrid:             return "hybrid";
+     case SearchStrategy::LimitedDiscrepancy: return "lds";
+     }
+     return "unknown";
+ }
@@ -0,0 +1,47 @@
+/**
+ * @file node_queue.hpp
+ * @brief Declaration of the open-node queue search engine.
+ *
+ * An alternative to the recursive depth-first search: open nodes are kept in an
+ * explicit queue and selected by SearchContext::searchStrategy (best-bound, hybrid
+ * dives or limited discrepancy). Nodes are evaluated by the same evaluateNode() routine
+ * as the recursive search, so bounds, logging and statistics are shared.
+ */
+
+ #ifndef NODE_QUEUE_HPP
+ #define NODE_QUEUE_HPP
+
+ #include "graph.hpp"
+ #include "search_context.hpp"
+ #include <string>
+ #include <vector>
+
+ /**
+  * @brief Solves a set of subproblems with the open-node queue engine.
+  *
+  * All OpenMP threads of the process pop nodes from a shared queue (one thread in
+  * deterministic mode). The queue is bounded by ctx.openNodeMemoryLimit (and by ctx.memoryLimit,
+  * see SearchContext::memoryNearLimit()): beyond it, popped nodes are solved depth-first
+  * by branchAndBound() without growing the queue.
+  *
+  * @param roots The subproblems (the children of each are explored like a search tree).
+  * @param bestSolution The best coloring solution found so far (updated).
+  * @param ctx The search context (time limit, strategy, statistics).
+  * @param depth Depth of the roots in the search tree.
+  */
+ void searchNodeQueue(const vector<Graph> &roots, ColoringSolution &bestSolution, SearchContext &ctx, int depth);
+
+ /**
+  * @brief Parses a strategy name (dfs, best-bound, hybrid, lds).
+  * @param name The name.
+  * @param strategy Output: the strategy.
+  * @return False if the name is unknown.
+  */
+ bool parseSearchStrategy(const string &name, SearchStrategy &strategy);
+
+ /**
+  * @brief Name of a strategy, as accepted by parseSearchStrategy().
+  */
+ const char *searchStrategyName(SearchStrategy strategy);
+
+ #endif // NODE_QUEUE_HPP
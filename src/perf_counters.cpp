@@ -0,0 +1,232 @@
+/**
+ * @file perf_counters.cpp
+ * @brief Implementation of the optional hardware performance counters.
+ */
+
+ #include "perf_counters.hpp"
+ #include <atomic>
+ #include <cstdint>
+ #include <cstring>
+ #include <memory>
+ #include <mutex>
+ #if defined(__linux__)
+ #include <linux/perf_event.h>
+ #include <sys/syscall.h>
+ #include <unistd.h>
+ #endif
+
+ namespace {
+
+ const int NUM_PHASES = 7;                        ///< Number of PerfPhase values.
+ const int ROW = PERF_VALUES_PER_PHASE + 2;       ///< Per-phase totals: calls, events, enabled and running time.
+
+ std::atomic<bool> enabled(false);
+ std::atomic<int> availableEvents(0);             // Bit e: some thread opened event e.
+
+ /**
+  * @brief The counter group and the per-phase totals of one thread.
+  *
+  * Only the owning thread writes the totals; they are atomics so that
+  * perfCounterTotals() may read them from another thread.
+  */
+ struct ThreadCounters {
+     int leader = -1;                             ///< Descriptor of the group leader (-1: none).
+     int numOpened = 0;                           ///< Number of events in the group.
+     int slot[PERF_NUM_EVENTS];                   ///< Position of each event in a group read (-1: missing).
+     std::vector<int> fds;                        ///< Every open descriptor of the group.
+     std::atomic<long long> totals[NUM_PHASES][ROW] = {};
+ };
+
+ std::mutex registryMutex;
+ std::vector<std::shared_ptr<ThreadCounters>> registry;  // Totals of every thread, kept after thread exit.
+
+ /**
+  * @brief Owns the counters of the calling thread and closes the group at thread exit.
+  */
+ struct ThreadHandle {
+     std::shared_ptr<ThreadCounters> counters;
+     ~ThreadHandle() {
+ #if defined(__linux__)
+         if (counters)
+             for (int fd : counters->fds)
+                 close(fd);
+ #endif
+     }
+ };
+
+ thread_local ThreadHandle threadHandle;
+
+ #if defined(__linux__)
+ /**
+  * @brief Opens one event for the calling thread (user space only).
+  * @return The descriptor, or -1 if the kernel refuses the event.
+  */
+ int openEvent(uint32_t type, uint64_t config, int groupFd) {
+     perf_event_attr attr;
+     std::memset(&attr, 0, sizeof(attr));
+     attr.size = sizeof(attr);
+     attr.type = type;
+     attr.config = config;
+     attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+     attr.exclude_kernel = 1;
+     attr.exclude_hv = 1;
+     return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, PERF_FLAG_FD_CLOEXEC));
+ }
+ #endif
+
+ /**
+  * @brief Opens the group of the calling thread: the task clock, then every hardware event accepted.
+  */
+ void openGroup(ThreadCounters &t) {
+     for (int e = 0; e < PERF_NUM_EVENTS; e++)
+         t.slot[e] = -1;
+ #if defined(__linux__)
+     static const struct { uint32_t type; uint64_t config; } events[PERF_NUM_EVENTS] = {
+         {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK},
+         {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+         {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+         {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES},
+         {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+         {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS},
+         {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+     };
+     for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+         int fd = openEvent(events[e].type, events[e].config, t.leader);
+         if (fd < 0) {
+             if (t.leader < 0) return;  // Without the leader, nothing is counted.
+             continue;
+         }
+         if (t.leader < 0) t.leader = fd;
+         t.fds.push_back(fd);
+         t.slot[e] = t.numOpened++;
+         availableEvents.fetch_or(1 << e);
+     }
+ #endif
+ }
+
+ /**
+  * @brief Returns the counters of the calling thread, opening them on first use.
+  */
+ ThreadCounters &threadCounters() {
+     if (!threadHandle.counters) {
+         auto t = std::make_shared<ThreadCounters>();
+         openGroup(*t);
+         std::lock_guard<std::mutex> lock(registryMutex);
+         registry.push_back(t);
+         threadHandle.counters = std::move(t);
+     }
+     return *threadHandle.counters;
+ }
+
+ /**
+  * @brief Reads the group of a thread.
+  * @param values Output: PERF_NUM_EVENTS event values, then the enabled and running times.
+  * @return False if the group is not open or the read failed.
+  */
+ bool readGroup(const ThreadCounters &t, long long *values) {
+ #if defined(__linux__)
+     if (t.leader < 0) return false;
+     uint64_t buf[3 + PERF_NUM_EVENTS];  // nr, time enabled, time running, one value per event.
+     ssize_t expected = static_cast<ssize_t>((3 + t.numOpened) * sizeof(uint64_t));
+     if (read(t.leader, buf, sizeof(buf)) < expected) return false;
+     for (int e = 0; e < PERF_NUM_EVENTS; e++)
+         values[e] = t.slot[e] >= 0 ? static_cast<long long>(buf[3 + t.slot[e]]) : 0;
+     values[PERF_NUM_EVENTS] = static_cast<long long>(buf[1]);
+     values[PERF_NUM_EVENTS + 1] = static_cast<long long>(buf[2]);
+     return true;
+ #else
+     (void)t;
+     (void)values;
+     return false;
+ #endif
+ }
+
+ /**
+  * @brief Adds to a total owned by the calling thread (no read-modify-write needed).
+  */
+ void add(std::atomic<long long> &total, long long value) {
+     total.store(total.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+ }
+
+ } // namespace
+
+ /**
+  * @brief Enables the counters for the whole process.
+  */
+ void enablePerfCounters() {
+     enabled = true;
+ }
+
+ /**
+  * @brief True if enablePerfCounters() was called.
+  */
+ bool perfCountersEnabled() {
+     return enabled.load();
+ }
+
+ /**
+  * @brief True if some thread of this process could open the given event.
+  */
+ bool perfEventAvailable(int event) {
+     return (availableEvents.load() >> event) & 1;
+ }
+
+ /**
+  * @brief Names of the phases, indexed as PerfPhase.
+  */
+ const std::vector<const char *> &perfPhaseNames() {
+     static const std::vector<const char *> names = {"node", "dsatur", "bounds", "max_clique", "branching",
+                                                     "merge", "add_edge"};
+     return names;
+ }
+
+ /**
+  * @brief Names of the events, indexed as PerfEvent.
+  */
+ const std::vector<const char *> &perfEventNames() {
+     static const std::vector<const char *> names = {"task_clock", "cycles", "instructions", "cache_references",
+                                                     "cache_misses", "branches", "branch_misses"};
+     return names;
+ }
+
+ /**
+  * @brief Sums the totals of all threads of this process (event counts scaled for multiplexing).
+  */
+ std::vector<long long> perfCounterTotals() {
+     std::vector<long long> result(NUM_PHASES * PERF_VALUES_PER_PHASE, 0);
+     std::lock_guard<std::mutex> lock(registryMutex);
+     for (const auto &t : registry)
+         for (int p = 0; p < NUM_PHASES; p++) {
+             const std::atomic<long long> *row = t->totals[p];
+             long long *out = &result[p * PERF_VALUES_PER_PHASE];
+             out[0] += row[0].load();
+             long long timeEnabled = row[1 + PERF_NUM_EVENTS].load(), timeRunning = row[2 + PERF_NUM_EVENTS].load();
+             double scale = timeRunning > 0 ? static_cast<double>(timeEnabled) / timeRunning : 0.0;
+             for (int e = 0; e < PERF_NUM_EVENTS; e++)
+                 out[1 + e] += static_cast<long long>(row[1 + e].load() * scale);
+         }
+     return result;
+ }
+
+ /**
+  * @brief Starts counting a scope (reads the group of the calling thread).
+  */
+ PerfRegion::PerfRegion(PerfPhase phase_) : phase(-1), counting(false) {
+     if (!enabled.load(std::memory_order_relaxed)) return;
+     phase = static_cast<int>(phase_);
+     counting = readGroup(threadCounters(), start);
+ }
+
+ /**
+  * @brief Adds the events of the scope to the totals of its phase.
+  */
+ PerfRegion::~PerfRegion() {
+     if (phase < 0) return;
+     ThreadCounters &t = threadCounters();
+     std::atomic<long long> *row = t.totals[phase];
+     add(row[0], 1);
+     long long end[PERF_NUM_EVENTS + 2];
+     if (!counting || !readGroup(t, end)) return;
+     for (int i = 0; i < PERF_NUM_EVENTS + 2; i++)
+         add(row[1 + i], end[i] - start[i]);
+ }
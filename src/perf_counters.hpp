@@ -0,0 +1,106 @@
+/**
+ * @file perf_counters.hpp
+ * @brief Declaration of the optional hardware performance counters (Linux perf_event_open).
+ *
+ * Once enabled, each thread opens one counter group the first time it enters an
+ * instrumented region: the task clock (a software event) leads the group, followed by
+ * the hardware events that the kernel accepts (cycles, instructions, cache references
+ * and misses, branches and branch misses). A PerfRegion reads the group on entry and
+ * exit and adds the difference to the totals of its phase in the calling thread.
+ * Regions may nest; the totals of a phase include its nested phases.
+ *
+ * Where the kernel refuses an event (no PMU in a virtual machine, perf_event_paranoid,
+ * seccomp), that event stays at zero and perfEventAvailable() is false for it; a
+ * disabled region costs one relaxed atomic load.
+ */
+
+ #ifndef PERF_COUNTERS_HPP
+ #define PERF_COUNTERS_HPP
+
+ #include <vector>
+
+ /**
+  * @brief Instrumented regions of the search.
+  */
+ enum class PerfPhase {
+     Node,        ///< evaluateNode(): one search node, including the phases below.
+     Dsatur,      ///< Graph::heuristicColoring(): the upper bound of a node.
+     Bounds,      ///< evaluateLowerBounds(): the lower-bound pipeline.
+     MaxClique,   ///< Graph::heuristicMaxClique() (inside the clique bound).
+     Branching,   ///< selectBranchingPair().
+     Merge,       ///< Graph::mergeVertices().
+     AddEdge      ///< Graph::addEdge().
+ };
+
+ /**
+  * @brief Counted events, in the order of the per-phase totals.
+  */
+ enum PerfEvent {
+     PERF_TASK_CLOCK,        ///< Thread CPU time (ns, software event).
+     PERF_CYCLES,
+     PERF_INSTRUCTIONS,
+     PERF_CACHE_REFERENCES,  ///< Last-level cache accesses.
+     PERF_CACHE_MISSES,      ///< Last-level cache misses.
+     PERF_BRANCHES,
+     PERF_BRANCH_MISSES,
+     PERF_NUM_EVENTS
+ };
+
+ /**
+  * @brief Number of values per phase in perfCounterTotals(): the call count, then the events.
+  */
+ const int PERF_VALUES_PER_PHASE = 1 + PERF_NUM_EVENTS;
+
+ /**
+  * @brief Enables the counters for the whole process (before the search starts).
+  */
+ void enablePerfCounters();
+
+ /**
+  * @brief True if enablePerfCounters() was called.
+  */
+ bool perfCountersEnabled();
+
+ /**
+  * @brief True if some thread of this process could open the given event.
+  * @param event A PerfEvent.
+  */
+ bool perfEventAvailable(int event);
+
+ /**
+  * @brief Names of the phases, indexed as PerfPhase.
+  */
+ const std::vector<const char *> &perfPhaseNames();
+
+ /**
+  * @brief Names of the events, indexed as PerfEvent.
+  */
+ const std::vector<const char *> &perfEventNames();
+
+ /**
+  * @brief Sums the totals of all threads of this process.
+  *
+  * Event counts are scaled by the time the group was enabled over the time it was
+  * counting, which corrects for counter multiplexing.
+  *
+  * @return PERF_VALUES_PER_PHASE values per phase, phases in PerfPhase order.
+  */
+ std::vector<long long> perfCounterTotals();
+
+ /**
+  * @brief Counts the events of a scope into the totals of a phase (if enabled).
+  */
+ class PerfRegion {
+ public:
+     explicit PerfRegion(PerfPhase phase);
+     ~PerfRegion();
+     PerfRegion(const PerfRegion &) = delete;
+     PerfRegion &operator=(const PerfRegion &) = delete;
+
+ private:
+     int phase;                             ///< Index of the phase, or -1 if disabled.
+     bool counting;                         ///< True if the group of the thread was read at entry.
+     long long start[PERF_NUM_EVENTS + 2];  ///< Group values at entry (events, enabled and running time).
+ };
+
+ #endif // PERF_COUNTERS_HPP
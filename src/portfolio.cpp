@@ -0,0 +1,202 @@
+/**
+ * @file portfolio.cpp
+ * @brief Implementation of the root upper-bound portfolio.
+ */
+
+ #include "portfolio.hpp"
+ #include <omp.h>
+ #include <algorithm>
+ #include <numeric>
+ #include <random>
+
+ // Tuning parameters.
+ static const int PORTFOLIO_RUNS              = 16;        ///< Runs per call, shared by the OpenMP threads.
+ static const double PORTFOLIO_TIME_SHARE     = 0.1;       ///< Share of the remaining time for the portfolio.
+ static const int RLF_MAX_VERTICES            = 5000;      ///< Largest graph colored by RLF (quadratic).
+ static const int GREEDY_MAX_ITERATIONS       = 500;       ///< Iterations of one iterated greedy run.
+ static const long long GREEDY_WORK           = 50000000;  ///< Vertex and edge visits of one iterated greedy run.
+
+ enum Heuristic { DSATUR, RANDOM_DSATUR, RLF, ITERATED_GREEDY };
+
+ /**
+  * @brief Number of colors of a coloring.
+  */
+ static int countColors(const vector<int> &color) {
+     int k = 0;
+     for (int c : color)
+         k = std::max(k, c + 1);
+     return k;
+ }
+
+ /**
+  * @brief DSATUR with ties broken by a random vertex rank.
+  */
+ static vector<int> randomizedDsatur(const Graph &g, std::mt19937 &rng) {
+     vector<int> rank(g.n);
+     std::iota(rank.begin(), rank.end(), 0);
+     std::shuffle(rank.begin(), rank.end(), rng);
+     return dsaturColoring(g, rank);
+ }
+
+ /**
+  * @brief Recursive largest first (Leighton).
+  *
+  * Each color class starts from the uncolored vertex with the most uncolored
+  * neighbors and grows by the candidate with the most neighbors among the vertices
+  * excluded from the class (ties: fewest candidate neighbors), which leaves the
+  * densest part of the graph for the later classes.
+  */
+ static vector<int> rlfColoring(const Graph &g) {
+     int n = g.n;
+     vector<int> color(n, -1), uncoloredDegree(n), excludedNeighbors(n, 0);
+     vector<char> candidate(n, 0);
+     vector<int> candidates;
+     for (int v = 0; v < n; v++)
+         uncoloredDegree[v] = g.degree(v);
+     int remaining = n;
+     for (int c = 0; remaining > 0; c++) {
+         candidates.clear();
+         int v = -1;
+         for (int u = 0; u < n; u++)
+             if (color[u] == -1) {
+                 candidate[u] = 1;
+                 excludedNeighbors[u] = 0;
+                 candidates.push_back(u);
+                 if (v == -1 || uncoloredDegree[u] > uncoloredDegree[v]) v = u;
+             }
+         while (v != -1) {
+             color[v] = c;
+             candidate[v] = 0;
+             remaining--;
+             for (int w : g.neighbors(v))
+                 if (color[w] == -1) uncoloredDegree[w]--;
+             // The candidate neighbors of v are excluded from the class.
+             for (int w : g.neighbors(v))
+                 if (candidate[w]) {
+                     candidate[w] = 0;
+                     for (int x : g.neighbors(w))
+                         if (candidate[x]) excludedNeighbors[x]++;
+                 }
+             v = -1;
+             size_t kept = 0;
+             for (int u : candidates) {
+                 if (!candidate[u]) continue;
+                 candidates[kept++] = u;
+                 if (v == -1 || excludedNeighbors[u] > excludedNeighbors[v] ||
+                     (excludedNeighbors[u] == excludedNeighbors[v] &&
+                      uncoloredDegree[u] - excludedNeighbors[u] < uncoloredDegree[v] - excludedNeighbors[v]))
+                     v = u;
+             }
+             candidates.resize(kept);
+         }
+     }
+     return color;
+ }
+
+ /**
+  * @brief Iterated greedy (Culberson): recolors the vertices class by class.
+  *
+  * First-fit over the vertices grouped by color class never uses more colors than the
+  * current coloring; the classes are visited in reverse, largest-first or random order.
+  */
+ static vector<int> iteratedGreedy(const Graph &g, vector<int> color, std::mt19937 &rng) {
+     int n = g.n;
+     long long work = n + 2 * g.numEdges() + 1;
+     int iterations = static_cast<int>(std::min<long long>(GREEDY_MAX_ITERATIONS, std::max<long long>(1, GREEDY_WORK / work)));
+     vector<long long> mark(n + 1, -1);  // mark[c] == stamp: color c is taken by a neighbor.
+     vector<int> order(n), next(n);
+     vector<vector<int>> classes;
+     for (int it = 0; it < iterations; it++) {
+         int k = countColors(color);
+         classes.assign(k, {});
+         for (int v = 0; v < n; v++)
+             classes[color[v]].push_back(v);
+         switch (it % 3) {
+         case 0: std::reverse(classes.begin(), classes.end()); break;
+         case 1: std::stable_sort(classes.begin(), classes.end(),
+                                  [](const vector<int> &a, const vector<int> &b) { return a.size() > b.size(); });
+                 break;
+         default: std::shuffle(classes.begin(), classes.end(), rng); break;
+         }
+         int pos = 0;
+         for (const vector<int> &cls : classes)
+             for (int v : cls)
+                 order[pos++] = v;
+         std::fill(next.begin(), next.end(), -1);
+         for (int v : order) {
+             long long stamp = static_cast<long long>(it) * n + v;
+             for (int w : g.neighbors(v))
+                 if (next[w] != -1) mark[next[w]] = stamp;
+             int c = 0;
+             while (mark[c] == stamp)
+                 c++;
+             next[v] = c;
+         }
+         color.swap(next);
+     }
+     return color;
+ }
+
+ /**
+  * @brief Colors a graph with the portfolio of heuristics.
+  * @param g The graph.
+  * @param ctx The search context (time limit, seed, statistics).
+  * @param salt Extra seed (e.g. the MPI rank).
+  * @return The best coloring found.
+  */
+ PortfolioResult portfolioColoring(const Graph &g, SearchContext &ctx, unsigned int salt) {
+     // The set of runs is fixed, whatever the thread count; the threads only share it.
+     const int runs = PORTFOLIO_RUNS;
+     double started = ctx.elapsed();
+     double deadline = started + PORTFOLIO_TIME_SHARE * std::max(0.0, ctx.timeLimit - started);
+
+     // Run 0 is plain DSATUR; its duration estimates the cost of the other runs, which
+     // are only started if they are expected to finish before the deadline.
+     vector<vector<int>> colorings(runs);
+     vector<int> numColors(runs, INF), heuristic(runs, DSATUR);
+     colorings[0] = g.heuristicColoring().second;
+     numColors[0] = countColors(colorings[0]);
+     double runCost = ctx.elapsed() - started;
+
+     // Run 1 is RLF; the others alternate randomized DSATUR and iterated greedy (started
+     // from a randomized DSATUR coloring).
+     #pragma omp parallel for schedule(dynamic, 1) num_threads(ctx.threads())
+     for (int r = 1; r < runs; r++) {
+         if (!ctx.deterministicMode && ctx.elapsed() + runCost >= deadline)
+             continue;
+         std::seed_seq seq{ctx.randomSeed, salt, static_cast<unsigned int>(r)};
+         std::mt19937 rng(seq);
+         if (r == 1 && g.n <= RLF_MAX_VERTICES) {
+             heuristic[r] = RLF;
+             colorings[r] = rlfColoring(g);
+         } else if (r % 2 == 1) {
+             heuristic[r] = RANDOM_DSATUR;
+             colorings[r] = randomizedDsatur(g, rng);
+         } else {
+             heuristic[r] = ITERATED_GREEDY;
+             colorings[r] = iteratedGreedy(g, randomizedDsatur(g, rng), rng);
+         }
+         numColors[r] = countColors(colorings[r]);
+     }
+
+     PortfolioResult result{INF, {}, DSATUR, 0};
+     int best = 0;
+     for (int r = 0; r < runs; r++) {
+         if (numColors[r] == INF) continue;
+         result.runs++;
+         if (numColors[r] < numColors[best]) best = r;
+     }
+     result.numColors = numColors[best];
+     result.coloring = std::move(colorings[best]);
+     result.heuristic = heuristic[best];
+     ctx.portfolioWins[result.heuristic]++;
+     return result;
+ }
+
+ /**
+  * @brief Names of the portfolio heuristics, indexed as PortfolioResult::heuristic.
+  */
+ const vector<const char *> &portfolioHeuristics() {
+     static const vector<const char *> names = {"dsatur", "random_dsatur", "rlf", "iterated_greedy"};
+     return names;
+ }
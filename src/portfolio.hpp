@@ -0,0 +1,50 @@
+/**
+ * @file portfolio.hpp
+ * @brief Declaration of the root upper-bound portfolio.
+ *
+ * Before the search starts, a component is colored by a portfolio of construction
+ * heuristics run in parallel on all OpenMP threads: DSATUR, DSATUR with randomized
+ * tie-breaking, recursive largest first (RLF) and iterated greedy with color-class
+ * reordering. The best coloring seeds the incumbent of the search.
+ */
+
+ #ifndef PORTFOLIO_HPP
+ #define PORTFOLIO_HPP
+
+ #include "graph.hpp"
+ #include "search_context.hpp"
+ #include <vector>
+
+ /**
+  * @brief Result of the portfolio.
+  */
+ struct PortfolioResult {
+     int numColors;         ///< Number of colors of the best coloring.
+     vector<int> coloring;  ///< The best coloring (indexed by the vertices of the graph).
+     int heuristic;         ///< Index of the winning heuristic in portfolioHeuristics().
+     int runs;              ///< Number of runs completed.
+ };
+
+ /**
+  * @brief Colors a graph with the portfolio of heuristics.
+  *
+  * The PORTFOLIO_RUNS runs are fixed and shared by the threads; every run is seeded from
+  * (ctx.randomSeed, salt, run index), and ties between runs go to the lowest run index,
+  * so the result does not depend on the thread count. Outside
+  * deterministic mode, a run is only started if it is expected (from the duration of the
+  * first, DSATUR, run) to end within PORTFOLIO_TIME_SHARE of the remaining time; the
+  * first run always completes.
+  *
+  * @param g The graph.
+  * @param ctx The search context (time limit, seed; the win is counted in portfolioWins).
+  * @param salt Extra seed (e.g. the MPI rank) so that processes run different variants.
+  * @return The best coloring found.
+  */
+ PortfolioResult portfolioColoring(const Graph &g, SearchContext &ctx, unsigned int salt);
+
+ /**
+  * @brief Names of the portfolio heuristics, indexed as PortfolioResult::heuristic.
+  */
+ const vector<const char *> &portfolioHeuristics();
+
+ #endif // PORTFOLIO_HPP
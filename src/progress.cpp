@@ -0,0 +1,175 @@
+/**
+ * @file progress.cpp
+ * @brief Implementation of the live progress report.
+ */
+
+ #include "progress.hpp"
+ #include <mpi.h>
+ #include <omp.h>
+ #include <unistd.h>
+ #include <algorithm>
+ #include <atomic>
+ #include <chrono>
+ #include <cstdio>
+ #include <fstream>
+ #include <thread>
+
+ static const int SUM_VALUES = 4;   ///< Summed: nodes, open tasks, resident bytes, searching processes.
+ static const int MAX_VALUES = 2;   ///< Maximized: lower bound, upper bound.
+
+ static bool enabled = false;
+ static bool pollFromAnyThread = false;
+ static MPI_Comm progressComm = MPI_COMM_NULL;
+ static int rank = 0, size = 1;
+ static double interval = 0;
+ static std::ostream *out = nullptr;
+ static std::atomic<int> lowerBound(0), upperBound(0);
+ static bool searching = true;
+ static long long epochs = 0;       // Epochs started.
+ static bool pending = false;       // The last epoch started is not complete.
+ static long long sendSum[SUM_VALUES], recvSum[SUM_VALUES];
+ static int sendMax[MAX_VALUES], recvMax[MAX_VALUES];
+ static MPI_Request requests[2];
+ static double lastTime = 0;        // Rank 0: time, node count and node rate of the previous status line.
+ static long long lastNodes = 0;
+ static double lastRate = 0;
+
+ /**
+  * @brief Resident memory of this process, in bytes (0 if unknown).
+  */
+ static long long residentBytes() {
+     std::ifstream statm("/proc/self/statm");
+     long long totalPages = 0, residentPages = 0;
+     if (!(statm >> totalPages >> residentPages)) return 0;
+     return residentPages * sysconf(_SC_PAGESIZE);
+ }
+
+ /**
+  * @brief Starts the reductions of the next epoch (caller holds the mpi critical section).
+  */
+ static void startEpoch(const SearchContext &ctx) {
+     sendSum[0] = ctx.nodesExplored.load();
+     sendSum[1] = ctx.openTasks.load();
+     sendSum[2] = residentBytes();
+     sendSum[3] = searching ? 1 : 0;
+     sendMax[0] = lowerBound.load();
+     sendMax[1] = searching ? std::max(upperBound.load(), ctx.incumbentColors.load()) : upperBound.load();
+     MPI_Iallreduce(sendSum, recvSum, SUM_VALUES, MPI_LONG_LONG, MPI_SUM, progressComm, &requests[0]);
+     MPI_Iallreduce(sendMax, recvMax, MAX_VALUES, MPI_INT, MPI_MAX, progressComm, &requests[1]);
+     epochs++;
+     pending = true;
+ }
+
+ /**
+  * @brief Handles a completed epoch: rank 0 prints the status line.
+  */
+ static void completeEpoch(const SearchContext &ctx) {
+     pending = false;
+     if (rank != 0) return;
+     double now = ctx.elapsed();
+     // An epoch that follows the previous one closely (at the end) keeps the previous rate.
+     bool fresh = now > lastTime && (lastTime == 0 || now - lastTime >= 0.5 * interval);
+     double rate = fresh ? (recvSum[0] - lastNodes) / (now - lastTime) : lastRate;
+     int lb = recvMax[0], ub = recvMax[1];
+     double gap = ub > 0 ? 100.0 * (ub - lb) / ub : 0.0;
+     char line[256];
+     std::snprintf(line, sizeof(line),
+                   "Progress: %.1f s, lower bound %d, upper bound %d, gap %.1f%%, %.3g nodes/s, "
+                   "%lld open tasks, %.1f MB, %lld/%d ranks searching",
+                   now, lb, ub, gap, rate, recvSum[1], recvSum[2] / 1048576.0, recvSum[3], size);
+     *out << line << std::endl;
+     lastTime = now;
+     lastNodes = recvSum[0];
+     lastRate = rate;
+ }
+
+ /**
+  * @brief Starts the progress report (collective over MPI_COMM_WORLD).
+  * @param interval_ Seconds between two status lines.
+  * @param out_ Stream of the status lines.
+  */
+ void initProgress(double interval_, std::ostream &out_) {
+     int threadLevel;
+     MPI_Query_thread(&threadLevel);
+     pollFromAnyThread = threadLevel >= MPI_THREAD_SERIALIZED;
+     MPI_Comm_dup(MPI_COMM_WORLD, &progressComm);
+     MPI_Comm_rank(progressComm, &rank);
+     MPI_Comm_size(progressComm, &size);
+     interval = interval_;
+     out = &out_;
+     enabled = true;
+ }
+
+ /**
+  * @brief Sets the bounds of this process outside the running search.
+  * @param lowerBound_ Best lower bound known to this process.
+  * @param upperBound_ Largest color count over the components not being searched.
+  */
+ void setProgressBounds(int lowerBound_, int upperBound_) {
+     lowerBound = lowerBound_;
+     upperBound = upperBound_;
+ }
+
+ /**
+  * @brief Starts the next epoch when it is due and completes the pending one.
+  * @param ctx The search context of this process.
+  */
+ void pollProgress(const SearchContext &ctx) {
+     if (!enabled) return;
+     if (!pollFromAnyThread && omp_get_thread_num() != 0) return;
+     #pragma omp critical(mpi)
+     {
+         if (pending) {
+             int done = 0;
+             MPI_Testall(2, requests, &done, MPI_STATUSES_IGNORE);
+             if (done) completeEpoch(ctx);
+         }
+         if (!pending && ctx.elapsed() >= (epochs + 1) * interval)
+             startEpoch(ctx);
+     }
+ }
+
+ /**
+  * @brief Waits for a request while joining the epochs.
+  * @param request The request.
+  * @param ctx The search context of this process.
+  */
+ void waitWithProgress(MPI_Request &request, const SearchContext &ctx) {
+     if (!enabled) {
+         MPI_Wait(&request, MPI_STATUS_IGNORE);
+         return;
+     }
+     while (true) {
+         int done = 0;
+         #pragma omp critical(mpi)
+         MPI_Test(&request, &done, MPI_STATUS_IGNORE);
+         if (done) return;
+         pollProgress(ctx);
+         std::this_thread::sleep_for(std::chrono::milliseconds(1));
+     }
+ }
+
+ /**
+  * @brief Joins the epochs until every process has ended its search (collective).
+  *
+  * A process that has ended starts its next epoch right away; the epoch completes when
+  * the processes still searching reach it, so they set the pace.
+  *
+  * @param ctx The search context of this process.
+  */
+ void finishProgress(const SearchContext &ctx) {
+     if (!enabled) return;
+     searching = false;
+     while (true) {
+         #pragma omp critical(mpi)
+         {
+             if (!pending)
+                 startEpoch(ctx);
+             MPI_Waitall(2, requests, MPI_STATUSES_IGNORE);
+             completeEpoch(ctx);
+         }
+         if (recvSum[3] == 0) break;  // Identical on every process.
+     }
+     MPI_Comm_free(&progressComm);
+     enabled = false;
+ }
@@ -0,0 +1,65 @@
+/**
+ * @file progress.hpp
+ * @brief Declaration of the live progress report of the solver.
+ *
+ * Every interval seconds (an epoch), each process contributes its node count, open
+ * tasks, resident memory, bounds and whether it is still searching to two non-blocking
+ * all-reductions (sums and maxima) on a private duplicate of MPI_COMM_WORLD. The search
+ * starts an epoch and tests the pending one every STOP_POLL_INTERVAL nodes, so it never
+ * blocks; when an epoch completes, rank 0 prints one status line with the elapsed time,
+ * the global lower and upper bounds, the gap, the node rate over the epoch, the open
+ * tasks and the memory. A process whose search has ended keeps joining the epochs in
+ * finishProgress() until every process has ended.
+ *
+ * MPI is called under the mpi OpenMP critical section, like the stop signal.
+ */
+
+ #ifndef PROGRESS_HPP
+ #define PROGRESS_HPP
+
+ #include "search_context.hpp"
+ #include <mpi.h>
+ #include <ostream>
+
+ /**
+  * @brief Starts the progress report (collective over MPI_COMM_WORLD).
+  * @param interval Seconds between two status lines (measured by the search context).
+  * @param out Stream of the status lines (used on rank 0).
+  */
+ void initProgress(double interval, std::ostream &out);
+
+ /**
+  * @brief Sets the bounds of this process outside the running search.
+  * @param lowerBound Best lower bound known to this process.
+  * @param upperBound Largest color count over the components of this process that are
+  *                   not being searched (finished or still waiting for their search).
+  */
+ void setProgressBounds(int lowerBound, int upperBound);
+
+ /**
+  * @brief Starts the next epoch when it is due and completes the pending one (never blocks).
+  *
+  * Called from the search (any thread) and between the component searches.
+  *
+  * @param ctx The search context of this process.
+  */
+ void pollProgress(const SearchContext &ctx);
+
+ /**
+  * @brief Waits for a request while joining the epochs (a plain MPI_Wait if disabled).
+  *
+  * For the blocking points inside a component search (e.g. the end of a group search),
+  * so that the other processes are not held up in their epochs.
+  *
+  * @param request The request (e.g. of a non-blocking collective).
+  * @param ctx The search context of this process.
+  */
+ void waitWithProgress(MPI_Request &request, const SearchContext &ctx);
+
+ /**
+  * @brief Joins the epochs until every process has ended its search (collective).
+  * @param ctx The search context of this process.
+  */
+ void finishProgress(const SearchContext &ctx);
+
+ #endif // PROGRESS_HPP
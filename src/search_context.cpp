@@ -0,0 +1,41 @@
+/**
+ * @file search_context.cpp
+ * @brief Implementation of the per-solve search context.
+ */
+
+ #include "search_context.hpp"
+ #include "lower_bounds.hpp"
+ #include "portfolio.hpp"
+ #include <omp.h>
+
+ /**
+  * @brief Creates a context with the default settings; startTime is now.
+  */
+ SearchContext::SearchContext()
+     : startTime(std::chrono::steady_clock::now()),
+       boundPrunes(lowerBoundPipeline().size()),
+       portfolioWins(portfolioHeuristics().size()) {}
+
+ /**
+  * @brief Seconds elapsed since startTime.
+  */
+ double SearchContext::elapsed() const {
+     using namespace std::chrono;
+     return duration_cast<duration<double>>(steady_clock::now() - startTime).count();
+ }
+
+ /**
+  * @brief Number of threads of the parallel regions of this solve.
+  */
+ int SearchContext::threads() const {
+     return numThreads > 0 ? numThreads : omp_get_max_threads();
+ }
+
+ /**
+  * @brief True if the graph memory of the search has reached MEMORY_LIMIT_SHARE of memoryLimit.
+  */
+ bool SearchContext::memoryNearLimit() const {
+     if (memoryLimit <= 0) return false;
+     long long held = graphMemory.current.load(std::memory_order_relaxed) + taskMemory.current.load(std::memory_order_relaxed);
+     return held >= MEMORY_LIMIT_SHARE * memoryLimit;
+ }
@@ -0,0 +1,197 @@
+/**
+ * @file search_context.hpp
+ * @brief Declaration of the per-solve search context (settings, shared state, statistics).
+ *
+ * Every search routine reads its configuration from, and reports its statistics to, the
+ * context of the solve it belongs to instead of process-wide globals, so independent
+ * solves can run concurrently in one process.
+ */
+
+ #ifndef SEARCH_CONTEXT_HPP
+ #define SEARCH_CONTEXT_HPP
+
+ #include <atomic>
+ #include <chrono>
+ #include <functional>
+ #include <ostream>
+ #include <vector>
+
+ /**
+  * @brief Node selection strategy of the search.
+  */
+ enum class SearchStrategy {
+     DepthFirst,          ///< Recursive depth-first search, merge child first.
+     BestBound,           ///< Node queue ordered by lower bound (deepest first on ties).
+     Hybrid,              ///< Depth-first dives started from the best-bound node.
+     LimitedDiscrepancy   ///< Iterated depth-first search allowing k addEdge branches, k = 0, 1, ...
+ };
+
+ /**
+  * @brief Share of SearchContext::memoryLimit at which the search stops spawning tasks.
+  */
+ const double MEMORY_LIMIT_SHARE = 0.9;
+
+ /**
+  * @brief Current and peak bytes of one kind of search memory.
+  */
+ struct MemoryGauge {
+     std::atomic<long long> current{0};   ///< Bytes held now.
+     std::atomic<long long> peak{0};      ///< Largest value of current.
+
+     /**
+      * @brief Adds bytes (negative: releases them) and raises the peak.
+      */
+     void add(long long bytes) {
+         long long now = current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+         long long seen = peak.load(std::memory_order_relaxed);
+         while (now > seen && !peak.compare_exchange_weak(seen, now, std::memory_order_relaxed)) {}
+     }
+ };
+
+ /**
+  * @brief Charges bytes to a gauge for the lifetime of a scope.
+  */
+ class MemoryCharge {
+ public:
+     MemoryCharge(MemoryGauge &gauge_, long long bytes_) : gauge(gauge_), bytes(bytes_) { gauge.add(bytes); }
+     ~MemoryCharge() { gauge.add(-bytes); }
+     MemoryCharge(const MemoryCharge &) = delete;
+     MemoryCharge &operator=(const MemoryCharge &) = delete;
+
+ private:
+     MemoryGauge &gauge;
+     long long bytes;
+ };
+
+ /**
+  * @brief Settings, shared state and statistics of one solve.
+  *
+  * The settings are written before the search starts and only read during it; the
+  * shared state and the statistics are atomic and updated by all search threads.
+  */
+ struct SearchContext {
+     // --- Settings ---
+
+     std::chrono::steady_clock::time_point startTime;  ///< Start of the solve (set by the constructor).
+     double timeLimit = 0;                 ///< Time limit measured from startTime (in seconds).
+     int numThreads = 0;                   ///< OpenMP threads of the parallel regions (0: OpenMP default).
+
+     /**
+      * @brief When true, the search runs in deterministic (reproducible) mode.
+      *
+      * Nodes are processed in a fixed depth-first order and the incumbent is only updated
+      * in that order, so node counts are reproducible for a given seed and configuration.
+      */
+     bool deterministicMode = false;
+
+     unsigned int randomSeed = 0;          ///< Seed for the randomized components of the solver.
+
+     /**
+      * @brief Search nodes at a depth smaller than this value also compute the
+      *        fractional chromatic (LP) bound; 0 disables it.
+      */
+     int lpBoundDepth = 0;
+
+     /**
+      * @brief Number of colors k of the decision mode (0: optimization mode).
+      *
+      * In decision mode every search starts with the incumbent k + 1 and stops at the
+      * first k-coloring.
+      */
+     int decisionColors = 0;
+
+     SearchStrategy searchStrategy = SearchStrategy::DepthFirst;  ///< Node selection strategy.
+
+     /**
+      * @brief Memory cap of the open-node queue, in bytes.
+      *
+      * While the queued graphs exceed the cap, popped nodes are solved by the recursive
+      * depth-first search instead of being expanded into the queue.
+      */
+     long long openNodeMemoryLimit = 1LL << 30;
+
+     /**
+      * @brief Cap on the graph memory of the search (graphMemory + taskMemory), in bytes; 0: none.
+      *
+      * Once the search holds MEMORY_LIMIT_SHARE of the cap, no more OpenMP tasks are
+      * spawned and the node queue stops growing: the subtrees are searched depth-first
+      * by the thread that reached them.
+      */
+     long long memoryLimit = 0;
+
+     std::ostream *log = nullptr;          ///< Per-node log (nullptr: no logging).
+
+     /**
+      * @brief Polled at every node with the number of nodes explored so far; the search
+      *        stops when it returns true (empty: never stops early).
+      */
+     std::function<bool(long long)> stopRequested;
+
+     /**
+      * @brief Called when the incumbent reaches decisionColors (decision mode only).
+      */
+     std::function<void()> onDecided;
+
+     // --- Shared state ---
+
+     /**
+      * @brief Number of colors that is good enough for the current search.
+      *
+      * A valid lower bound on the chromatic number of the whole input graph: once the
+      * incumbent of a (component) search uses at most this many colors, the search stops.
+      */
+     std::atomic<int> colorTarget{0};
+
+     /**
+      * @brief Fewest colors found by the other processes of a shared search (0: none).
+      *
+      * Nodes are pruned against it as against the incumbent, so a process stops looking
+      * for colorings that another process already beat.
+      */
+     std::atomic<int> sharedColors{0};
+
+     std::atomic<bool> completed{true};    ///< False once a search hit the time limit.
+
+     // --- Statistics ---
+
+     std::atomic<long long> nodesExplored{0};   ///< Branch-and-bound nodes explored.
+     std::atomic<long long> arenaBytes{0};      ///< Bytes of per-node scratch data drawn from the thread arenas.
+     std::atomic<long long> openNodesPeak{0};   ///< Largest number of open nodes held in a node queue.
+     std::atomic<long long> openTasks{0};       ///< Spawned search tasks and queued nodes not yet finished.
+     std::atomic<int> incumbentColors{0};       ///< Colors of the latest incumbent found by the search (0: none).
+     MemoryGauge graphMemory;                   ///< Child graphs of the expanded nodes (shared with their tasks, if spawned).
+     MemoryGauge taskMemory;                    ///< Graphs held by subproblem lists and node queues.
+     std::atomic<long long> memoryLimitedNodes{0};  ///< Nodes that did not spawn tasks because of memoryLimit.
+     std::vector<std::atomic<long long>> boundPrunes;    ///< Nodes pruned per bound of lowerBoundPipeline().
+     std::vector<std::atomic<long long>> portfolioWins;  ///< Portfolio calls won per heuristic of portfolioHeuristics().
+
+     /**
+      * @brief Creates a context with the default settings; startTime is now.
+      */
+     SearchContext();
+
+     SearchContext(const SearchContext &) = delete;
+     SearchContext &operator=(const SearchContext &) = delete;
+
+     /**
+      * @brief Seconds elapsed since startTime.
+      */
+     double elapsed() const;
+
+     /**
+      * @brief True once the time limit is reached.
+      */
+     bool timeUp() const { return elapsed() >= timeLimit; }
+
+     /**
+      * @brief Number of threads of the parallel regions of this solve.
+      */
+     int threads() const;
+
+     /**
+      * @brief True if the graph memory of the search has reached MEMORY_LIMIT_SHARE of memoryLimit.
+      */
+     bool memoryNearLimit() const;
+ };
+
+ #endif // SEARCH_CONTEXT_HPP
@@ -0,0 +1,182 @@
+/**
+ * @file service.cpp
+ * @brief Implementation of the resident coloring service.
+ */
+
+ #include "service.hpp"
+ #include "coloring.hpp"
+ #include <omp.h>
+ #include <atomic>
+ #include <cerrno>
+ #include <csignal>
+ #include <cstring>
+ #include <iostream>
+ #include <memory>
+ #include <sys/socket.h>
+ #include <sys/un.h>
+ #include <unistd.h>
+
+ namespace {
+
+ int listenFd = -1;                          // Listening socket (shut down to stop the workers).
+ std::atomic<bool> stopping(false);          // Set by a shutdown request or a signal.
+ std::unique_ptr<std::atomic<int>[]> openFd; // Connection of each worker (-1: none).
+ int numWorkers = 0;
+
+ /**
+  * @brief Stops the service: wakes up every worker blocked in accept() or in a read.
+  *
+  * Requests being solved are still answered. Only calls shutdown(), so it may run in
+  * a signal handler.
+  */
+ void stopService() {
+     stopping = true;
+     shutdown(listenFd, SHUT_RDWR);
+     for (int w = 0; w < numWorkers; w++) {
+         int fd = openFd[w].load();
+         if (fd >= 0) shutdown(fd, SHUT_RD);
+     }
+ }
+
+ void onSignal(int) {
+     stopService();
+ }
+
+ /**
+  * @brief Reads exactly size bytes; false on end of stream or error.
+  */
+ bool readAll(int fd, void *data, size_t size) {
+     char *p = static_cast<char *>(data);
+     while (size > 0) {
+         ssize_t got = read(fd, p, size);
+         if (got < 0 && errno == EINTR) continue;
+         if (got <= 0) return false;
+         p += got;
+         size -= static_cast<size_t>(got);
+     }
+     return true;
+ }
+
+ /**
+  * @brief Writes exactly size bytes; false on error.
+  */
+ bool writeAll(int fd, const void *data, size_t size) {
+     const char *p = static_cast<const char *>(data);
+     while (size > 0) {
+         ssize_t put = send(fd, p, size, MSG_NOSIGNAL);
+         if (put < 0 && errno == EINTR) continue;
+         if (put <= 0) return false;
+         p += put;
+         size -= static_cast<size_t>(put);
+     }
+     return true;
+ }
+
+ /**
+  * @brief Answers the requests of one connection until it is closed.
+  */
+ void serveConnection(int fd) {
+     ServiceRequest request;
+     vector<int32_t> pairs;
+     vector<pair<int, int>> edges;
+     while (readAll(fd, &request, sizeof(request))) {
+         if (request.magic == SERVICE_MAGIC && request.version == SERVICE_VERSION &&
+             request.type == SERVICE_SHUTDOWN) {
+             stopService();
+             return;
+         }
+         ServiceResponse response{SERVICE_MAGIC, SERVICE_BAD_REQUEST, 0, 0, 0, 0, 0, 0};
+         bool valid = request.magic == SERVICE_MAGIC && request.version == SERVICE_VERSION &&
+                      request.type == SERVICE_SOLVE && request.reserved == 0 &&
+                      request.numVertices >= 0 && request.numVertices <= SERVICE_MAX_VERTICES &&
+                      request.numEdges >= 0 && request.numEdges <= SERVICE_MAX_EDGES &&
+                      request.timeLimit >= 0;
+         if (!valid) {
+             writeAll(fd, &response, sizeof(response));
+             return;
+         }
+         pairs.resize(2 * static_cast<size_t>(request.numEdges));
+         if (!readAll(fd, pairs.data(), pairs.size() * sizeof(int32_t))) return;
+         // An edge with an endpoint out of range or a loop would be dropped silently by
+         // Graph::fromEdges, and the coloring would be of another graph.
+         edges.clear();
+         for (size_t i = 0; i < pairs.size(); i += 2) {
+             int u = pairs[i], v = pairs[i + 1];
+             if (u < 0 || u >= request.numVertices || v < 0 || v >= request.numVertices || u == v) {
+                 writeAll(fd, &response, sizeof(response));
+                 return;
+             }
+             edges.emplace_back(u, v);
+         }
+
+         SolveOptions options;
+         options.timeLimit = request.timeLimit;
+         options.deterministic = (request.flags & 1) != 0;
+         options.seed = request.seed;
+         options.lowerBound = request.lowerBound;
+         SolveResult result = solveColoring(Graph::fromEdges(request.numVertices, edges), options);
+
+         response.status = SERVICE_OK;
+         response.numColors = result.numColors;
+         response.lowerBound = result.lowerBound;
+         response.optimal = result.optimal ? 1 : 0;
+         response.numVertices = request.numVertices;
+         response.nodes = result.nodes;
+         response.seconds = result.seconds;
+         vector<int32_t> colors(result.coloring.begin(), result.coloring.end());
+         if (!writeAll(fd, &response, sizeof(response)) ||
+             !writeAll(fd, colors.data(), colors.size() * sizeof(int32_t)))
+             return;
+     }
+ }
+
+ } // namespace
+
+ /**
+  * @brief Runs the service until a shutdown request or SIGINT/SIGTERM.
+  * @param socketPath Path of the Unix domain socket (replaced if it exists).
+  * @param workers Number of worker threads (concurrent connections).
+  * @return 0 on a clean shutdown, 1 if the socket cannot be created.
+  */
+ int runService(const std::string &socketPath, int workers) {
+     sockaddr_un address{};
+     address.sun_family = AF_UNIX;
+     if (socketPath.size() >= sizeof(address.sun_path)) {
+         std::cerr << "Socket path too long: " << socketPath << std::endl;
+         return 1;
+     }
+     std::strcpy(address.sun_path, socketPath.c_str());
+     unlink(socketPath.c_str());
+     listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+     if (listenFd < 0 || bind(listenFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 ||
+         listen(listenFd, SOMAXCONN) < 0) {
+         std::cerr << "Error opening socket " << socketPath << ": " << std::strerror(errno) << std::endl;
+         return 1;
+     }
+     numWorkers = workers;
+     openFd.reset(new std::atomic<int>[workers]);
+     for (int w = 0; w < workers; w++)
+         openFd[w] = -1;
+     std::signal(SIGINT, onSignal);
+     std::signal(SIGTERM, onSignal);
+     std::cout << "Listening on " << socketPath << " with " << workers << " workers" << std::endl;
+
+     // The workers live as long as the service, so their thread arenas stay warm.
+     #pragma omp parallel num_threads(workers)
+     {
+         while (!stopping) {
+             int fd = accept(listenFd, nullptr, nullptr);
+             if (fd < 0) {
+                 if (errno == EINTR || errno == ECONNABORTED) continue;
+                 break;  // The socket was shut down.
+             }
+             openFd[omp_get_thread_num()] = fd;
+             if (!stopping) serveConnection(fd);
+             openFd[omp_get_thread_num()] = -1;
+             close(fd);
+         }
+     }
+     close(listenFd);
+     unlink(socketPath.c_str());
+     return 0;
+ }
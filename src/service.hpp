@@ -0,0 +1,89 @@
+/**
+ * @file service.hpp
+ * @brief Declaration of the resident coloring service and its binary protocol.
+ *
+ * The service listens on a Unix domain socket. Each of its worker threads (the OpenMP
+ * threads of one parallel region, which stay alive with their arenas for the lifetime
+ * of the service) accepts a connection and answers its requests in order until the
+ * client closes it. Every request is solved with solveColoring() on the worker thread.
+ *
+ * All fields are in host byte order (the socket is local). A request is a
+ * ServiceRequest followed by numEdges pairs of int32 vertex indices (0-indexed, below
+ * numVertices and distinct within a pair; anything else is a bad request); the
+ * answer is a ServiceResponse followed by numVertices int32 colors when status is
+ * SERVICE_OK.
+ */
+
+ #ifndef SERVICE_HPP
+ #define SERVICE_HPP
+
+ #include <cstdint>
+ #include <string>
+
+ const uint32_t SERVICE_MAGIC   = 0x47435251;  ///< "GCRQ": first field of every message.
+ const uint32_t SERVICE_VERSION = 1;           ///< Protocol version.
+
+ /**
+  * @brief Kind of a request.
+  */
+ enum ServiceRequestType : uint32_t {
+     SERVICE_SOLVE    = 0,  ///< Color the graph that follows.
+     SERVICE_SHUTDOWN = 1   ///< Stop the service (no payload, no answer).
+ };
+
+ /**
+  * @brief Status of an answer.
+  */
+ enum ServiceStatus : int32_t {
+     SERVICE_OK          = 0,  ///< The coloring follows.
+     SERVICE_BAD_REQUEST = 1   ///< Malformed request; the connection is closed.
+ };
+
+ /**
+  * @brief Fixed part of a request.
+  */
+ struct ServiceRequest {
+     uint32_t magic;        ///< SERVICE_MAGIC.
+     uint32_t version;      ///< SERVICE_VERSION.
+     uint32_t type;         ///< A ServiceRequestType.
+     uint32_t flags;        ///< Bit 0: deterministic search.
+     int32_t numVertices;   ///< Number of vertices.
+     int32_t lowerBound;    ///< A known lower bound on the chromatic number (0: none).
+     int64_t numEdges;      ///< Number of edge pairs that follow.
+     double timeLimit;      ///< Time budget of the solve (in seconds).
+     uint32_t seed;         ///< Seed of the randomized heuristics.
+     int32_t reserved;      ///< Must be 0.
+ };
+
+ /**
+  * @brief Fixed part of an answer.
+  */
+ struct ServiceResponse {
+     uint32_t magic;        ///< SERVICE_MAGIC.
+     int32_t status;        ///< A ServiceStatus.
+     int32_t numColors;     ///< Number of colors of the coloring.
+     int32_t lowerBound;    ///< Proven lower bound on the chromatic number.
+     int32_t optimal;       ///< 1 if the coloring is optimal.
+     int32_t numVertices;   ///< Number of colors that follow.
+     int64_t nodes;         ///< Branch-and-bound nodes explored.
+     double seconds;        ///< Solve time (in seconds).
+ };
+
+ static_assert(sizeof(ServiceRequest) == 48, "ServiceRequest must have no padding");
+ static_assert(sizeof(ServiceResponse) == 40, "ServiceResponse must have no padding");
+
+ /**
+  * @brief Largest graph accepted by the service.
+  */
+ const int32_t SERVICE_MAX_VERTICES = 1 << 24;
+ const int64_t SERVICE_MAX_EDGES    = 1LL << 27;
+
+ /**
+  * @brief Runs the service until a shutdown request or SIGINT/SIGTERM.
+  * @param socketPath Path of the Unix domain socket (replaced if it exists).
+  * @param workers Number of worker threads (concurrent connections).
+  * @return 0 on a clean shutdown, 1 if the socket cannot be created.
+  */
+ int runService(const std::string &socketPath, int workers);
+
+ #endif // SERVICE_HPP
@@ -0,0 +1,36 @@
+/**
+ * @file service_main.cpp
+ * @brief Entry point of the resident coloring service.
+ *
+ * @par Usage Example:
+ * @code
+ *   ./coloring_service <socket_path> [--workers <n>]
+ * @endcode
+ *
+ * The service does not use MPI. Without --workers it runs OMP_NUM_THREADS workers
+ * (OpenMP default); see service.hpp for the protocol.
+ */
+
+ #include "service.hpp"
+ #include <omp.h>
+ #include <cstdlib>
+ #include <iostream>
+ #include <string>
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <socket_path> [--workers <n>]\n";
+        return 1;
+    }
+    int workers = omp_get_max_threads();
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--workers" && i + 1 < argc && std::atoi(argv[i + 1]) > 0) {
+            workers = std::atoi(argv[++i]);
+        } else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return 1;
+        }
+    }
+    return runService(argv[1], workers);
+}
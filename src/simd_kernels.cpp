@@ -0,0 +1,312 @@
+/**
+ * @file simd_kernels.cpp
+ * @brief Implementation of the SIMD set-intersection and popcount kernels with runtime dispatch.
+ */
+
+ #include "simd_kernels.hpp"
+ #include <immintrin.h>
+ #include <algorithm>
+ #include <cstdlib>
+ #include <cstring>
+
+ // --- Scalar kernels ---
+
+ static int popcountScalar(const uint64_t *a, int words) {
+     int c = 0;
+     for (int k = 0; k < words; k++) c += __builtin_popcountll(a[k]);
+     return c;
+ }
+
+ static int andCountScalar(const uint64_t *a, const uint64_t *b, int words) {
+     int c = 0;
+     for (int k = 0; k < words; k++) c += __builtin_popcountll(a[k] & b[k]);
+     return c;
+ }
+
+ static void andScalar(uint64_t *dst, const uint64_t *a, const uint64_t *b, int words) {
+     for (int k = 0; k < words; k++) dst[k] = a[k] & b[k];
+ }
+
+ static void andNotScalar(uint64_t *dst, const uint64_t *a, const uint64_t *b, int words) {
+     for (int k = 0; k < words; k++) dst[k] = a[k] & ~b[k];
+ }
+
+ /**
+  * @brief Merge-based intersection of the remaining elements; shared by all kernels as the tail loop.
+  */
+ static int intersectScalarFrom(const int *a, int i, int na, const int *b, int j, int nb, int *out, int k) {
+     while (i < na && j < nb) {
+         if (a[i] < b[j]) i++;
+         else if (a[i] > b[j]) j++;
+         else { if (out) out[k] = a[i]; k++; i++; j++; }
+     }
+     return k;
+ }
+
+ static int intersectScalar(const int *a, int na, const int *b, int nb, int *out) {
+     return intersectScalarFrom(a, 0, na, b, 0, nb, out, 0);
+ }
+
+ /**
+  * @brief Galloping intersection: each element of the short list is located in the long
+  * one by exponential search followed by binary search, in O(ns log(nl / ns)).
+  *
+  * Output elements come from positions at or after the write position in either list,
+  * so out may alias a as for the other kernels.
+  */
+ static int intersectGalloping(const int *small, int ns, const int *large, int nl, int *out) {
+     int k = 0, lo = 0;
+     for (int i = 0; i < ns && lo < nl; i++) {
+         int x = small[i];
+         int hi = lo;
+         for (int step = 1; hi < nl && large[hi] < x; step <<= 1) {
+             lo = hi + 1;
+             hi += step;
+         }
+         lo = std::lower_bound(large + lo, large + std::min(hi, nl), x) - large;
+         if (lo < nl && large[lo] == x) {
+             if (out) out[k] = x;
+             k++;
+             lo++;
+         }
+     }
+     return k;
+ }
+
+ // --- AVX2 kernels ---
+
+ /**
+  * @brief Per-byte popcount of a 256-bit vector summed into four 64-bit lanes (nibble lookup).
+  */
+ __attribute__((target("avx2")))
+ static inline __m256i popcount256(__m256i v) {
+     const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                             0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+     const __m256i low = _mm256_set1_epi8(0x0f);
+     __m256i lo = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, low));
+     __m256i hi = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), low));
+     return _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256());
+ }
+
+ __attribute__((target("avx2")))
+ static int horizontalSum256(__m256i acc) {
+     alignas(32) uint64_t lanes[4];
+     _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), acc);
+     return static_cast<int>(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+ }
+
+ __attribute__((target("avx2")))
+ static int popcountAvx2(const uint64_t *a, int words) {
+     __m256i acc = _mm256_setzero_si256();
+     int k = 0;
+     for (; k + 4 <= words; k += 4)
+         acc = _mm256_add_epi64(acc, popcount256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + k))));
+     return horizontalSum256(acc) + popcountScalar(a + k, words - k);
+ }
+
+ __attribute__((target("avx2")))
+ static int andCountAvx2(const uint64_t *a, const uint64_t *b, int words) {
+     __m256i acc = _mm256_setzero_si256();
+     int k = 0;
+     for (; k + 4 <= words; k += 4) {
+         __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + k));
+         __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + k));
+         acc = _mm256_add_epi64(acc, popcount256(_mm256_and_si256(va, vb)));
+     }
+     return horizontalSum256(acc) + andCountScalar(a + k, b + k, words - k);
+ }
+
+ __attribute__((target("avx2")))
+ static void andAvx2(uint64_t *dst, const uint64_t *a, const uint64_t *b, int words) {
+     int k = 0;
+     for (; k + 4 <= words; k += 4) {
+         __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + k));
+         __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + k));
+         _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + k), _mm256_and_si256(va, vb));
+     }
+     andScalar(dst + k, a + k, b + k, words - k);
+ }
+
+ __attribute__((target("avx2")))
+ static void andNotAvx2(uint64_t *dst, const uint64_t *a, const uint64_t *b, int words) {
+     int k = 0;
+     for (; k + 4 <= words; k += 4) {
+         __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + k));
+         __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + k));
+         _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + k), _mm256_andnot_si256(vb, va));
+     }
+     andNotScalar(dst + k, a + k, b + k, words - k);
+ }
+
+ /**
+  * @brief Block intersection: a[i] is compared against 8 elements of b at once.
+  *
+  * If a[i] is at most the last element of the block, any match lies in the block and
+  * a advances; otherwise the whole block is smaller than a[i] and b advances by 8.
+  */
+ __attribute__((target("avx2")))
+ static int intersectAvx2(const int *a, int na, const int *b, int nb, int *out) {
+     int i = 0, j = 0, k = 0;
+     while (i < na && j + 8 <= nb) {
+         __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + j));
+         int x = a[i];
+         int last = b[j + 7];
+         if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(block, _mm256_set1_epi32(x)))) {
+             if (out) out[k] = x;
+             k++;
+         }
+         if (x < last) i++;
+         else if (x > last) j += 8;
+         else { i++; j += 8; }
+     }
+     return intersectScalarFrom(a, i, na, b, j, nb, out, k);
+ }
+
+ // --- AVX-512 kernels ---
+
+ __attribute__((target("avx512f,avx512vpopcntdq")))
+ static int popcountAvx512(const uint64_t *a, int words) {
+     __m512i acc = _mm512_setzero_si512();
+     int k = 0;
+     for (; k + 8 <= words; k += 8)
+         acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(_mm512_loadu_si512(a + k)));
+     if (k < words) {
+         __mmask8 m = static_cast<__mmask8>((1u << (words - k)) - 1);
+         acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(_mm512_maskz_loadu_epi64(m, a + k)));
+     }
+     return static_cast<int>(_mm512_reduce_add_epi64(acc));
+ }
+
+ __attribute__((target("avx512f,avx512vpopcntdq")))
+ static int andCountAvx512(const uint64_t *a, const uint64_t *b, int words) {
+     __m512i acc = _mm512_setzero_si512();
+     int k = 0;
+     for (; k + 8 <= words; k += 8)
+         acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(
+                   _mm512_and_si512(_mm512_loadu_si512(a + k), _mm512_loadu_si512(b + k))));
+     if (k < words) {
+         __mmask8 m = static_cast<__mmask8>((1u << (words - k)) - 1);
+         acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(
+                   _mm512_and_si512(_mm512_maskz_loadu_epi64(m, a + k), _mm512_maskz_loadu_epi64(m, b + k))));
+     }
+     return static_cast<int>(_mm512_reduce_add_epi64(acc));
+ }
+
+ __attribute__((target("avx512f")))
+ static void andAvx512(uint64_t *dst, const uint64_t *a, const uint64_t *b, int words) {
+     int k = 0;
+     for (; k + 8 <= words; k += 8)
+         _mm512_storeu_si512(dst + k, _mm512_and_si512(_mm512_loadu_si512(a + k), _mm512_loadu_si512(b + k)));
+     andScalar(dst + k, a + k, b + k, words - k);
+ }
+
+ __attribute__((target("avx512f")))
+ static void andNotAvx512(uint64_t *dst, const uint64_t *a, const uint64_t *b, int words) {
+     int k = 0;
+     for (; k + 8 <= words; k += 8)
+         _mm512_storeu_si512(dst + k, _mm512_andnot_si512(_mm512_loadu_si512(b + k), _mm512_loadu_si512(a + k)));
+     andNotScalar(dst + k, a + k, b + k, words - k);
+ }
+
+ /**
+  * @brief Block intersection with 16-element blocks of b (see intersectAvx2).
+  */
+ __attribute__((target("avx512f")))
+ static int intersectAvx512(const int *a, int na, const int *b, int nb, int *out) {
+     int i = 0, j = 0, k = 0;
+     while (i < na && j + 16 <= nb) {
+         __m512i block = _mm512_loadu_si512(b + j);
+         int x = a[i];
+         int last = b[j + 15];
+         if (_mm512_cmpeq_epi32_mask(block, _mm512_set1_epi32(x))) {
+             if (out) out[k] = x;
+             k++;
+         }
+         if (x < last) i++;
+         else if (x > last) j += 16;
+         else { i++; j += 16; }
+     }
+     return intersectScalarFrom(a, i, na, b, j, nb, out, k);
+ }
+
+ // --- Dispatch ---
+
+ /**
+  * @brief Function table of the selected kernels.
+  */
+ struct SimdKernels {
+     SimdLevel level;
+     int (*popcount)(const uint64_t *, int);
+     int (*andCount)(const uint64_t *, const uint64_t *, int);
+     void (*bitAnd)(uint64_t *, const uint64_t *, const uint64_t *, int);
+     void (*bitAndNot)(uint64_t *, const uint64_t *, const uint64_t *, int);
+     int (*intersect)(const int *, int, const int *, int, int *);
+ };
+
+ /**
+  * @brief Selects the widest kernels supported by the CPU (or requested via SOLVER_SIMD).
+  */
+ static SimdKernels selectKernels() {
+     __builtin_cpu_init();
+     bool avx2 = __builtin_cpu_supports("avx2");
+     bool avx512 = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vpopcntdq");
+     if (const char *request = std::getenv("SOLVER_SIMD")) {
+         if (std::strcmp(request, "scalar") == 0) avx2 = avx512 = false;
+         else if (std::strcmp(request, "avx2") == 0) avx512 = false;
+     }
+     if (avx512)
+         return {SimdLevel::Avx512, popcountAvx512, andCountAvx512, andAvx512, andNotAvx512, intersectAvx512};
+     if (avx2)
+         return {SimdLevel::Avx2, popcountAvx2, andCountAvx2, andAvx2, andNotAvx2, intersectAvx2};
+     return {SimdLevel::Scalar, popcountScalar, andCountScalar, andScalar, andNotScalar, intersectScalar};
+ }
+
+ static const SimdKernels &kernels() {
+     static const SimdKernels table = selectKernels();
+     return table;
+ }
+
+ SimdLevel simdLevel() {
+     return kernels().level;
+ }
+
+ const char *simdLevelName() {
+     switch (kernels().level) {
+     case SimdLevel::Avx512: return "avx512";
+     case SimdLevel::Avx2:   return "avx2";
+     default:                return "scalar";
+     }
+ }
+
+ int bitsetPopcount(const uint64_t *a, int words) {
+     return kernels().popcount(a, words);
+ }
+
+ int bitsetAndCount(const uint64_t *a, const uint64_t *b, int words) {
+     return kernels().andCount(a, b, words);
+ }
+
+ void bitsetAnd(uint64_t *dst, const uint64_t *a, const uint64_t *b, int words) {
+     kernels().bitAnd(dst, a, b, words);
+ }
+
+ void bitsetAndNot(uint64_t *dst, const uint64_t *a, const uint64_t *b, int words) {
+     kernels().bitAndNot(dst, a, b, words);
+ }
+
+ /**
+  * @brief Length ratio from which the galloping kernel replaces the merge-based ones.
+  */
+ static const int GALLOP_RATIO = 32;
+
+ int sortedIntersect(const int *a, int na, const int *b, int nb, int *out) {
+     if (na >= GALLOP_RATIO * static_cast<long long>(nb))
+         return intersectGalloping(b, nb, a, na, out);
+     if (nb >= GALLOP_RATIO * static_cast<long long>(na))
+         return intersectGalloping(a, na, b, nb, out);
+     return kernels().intersect(a, na, b, nb, out);
+ }
+
+ int sortedIntersectCount(const int *a, int na, const int *b, int nb) {
+     return sortedIntersect(a, na, b, nb, nullptr);
+ }
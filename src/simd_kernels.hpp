@@ -0,0 +1,78 @@
+/**
+ * @file simd_kernels.hpp
+ * @brief Declaration of the SIMD set-intersection and popcount kernels.
+ *
+ * Every kernel has a scalar, an AVX2 and an AVX-512 (F + VPOPCNTDQ) implementation;
+ * the widest one supported by the CPU is selected once at first use. The selection
+ * can be overridden with the SOLVER_SIMD environment variable (scalar, avx2, avx512).
+ *
+ * Intersections of lists whose lengths differ by a large factor use a galloping
+ * (exponential search) kernel instead, whatever the instruction set.
+ */
+
+ #ifndef SIMD_KERNELS_HPP
+ #define SIMD_KERNELS_HPP
+
+ #include <cstdint>
+
+ /**
+  * @brief Instruction set used by the kernels.
+  */
+ enum class SimdLevel {
+     Scalar,  ///< Portable fallback.
+     Avx2,    ///< AVX2 (nibble-lookup popcount).
+     Avx512   ///< AVX-512 F with VPOPCNTDQ.
+ };
+
+ /**
+  * @brief Returns the instruction set selected for this process.
+  */
+ SimdLevel simdLevel();
+
+ /**
+  * @brief Returns a printable name of the selected instruction set.
+  */
+ const char *simdLevelName();
+
+ /**
+  * @brief Number of set bits in a word array.
+  * @param a The words.
+  * @param words Number of words.
+  */
+ int bitsetPopcount(const uint64_t *a, int words);
+
+ /**
+  * @brief Number of set bits in a AND b.
+  * @param a First word array.
+  * @param b Second word array.
+  * @param words Number of words.
+  */
+ int bitsetAndCount(const uint64_t *a, const uint64_t *b, int words);
+
+ /**
+  * @brief dst = a AND b (dst may alias a or b).
+  */
+ void bitsetAnd(uint64_t *dst, const uint64_t *a, const uint64_t *b, int words);
+
+ /**
+  * @brief dst = a AND NOT b (dst may alias a or b).
+  */
+ void bitsetAndNot(uint64_t *dst, const uint64_t *a, const uint64_t *b, int words);
+
+ /**
+  * @brief Intersection of two strictly increasing integer arrays.
+  * @param a First array.
+  * @param na Length of a.
+  * @param b Second array.
+  * @param nb Length of b.
+  * @param out Output array with room for min(na, nb) elements (may alias a).
+  * @return Number of elements written to out (in increasing order).
+  */
+ int sortedIntersect(const int *a, int na, const int *b, int nb, int *out);
+
+ /**
+  * @brief Size of the intersection of two strictly increasing integer arrays.
+  */
+ int sortedIntersectCount(const int *a, int na, const int *b, int nb);
+
+ #endif // SIMD_KERNELS_HPP
@@ -0,0 +1,169 @@
+/**
+ * @file stop_signal.cpp
+ * @brief Implementation of the cross-process stop signal.
+ */
+
+ #include "stop_signal.hpp"
+ #include <mpi.h>
+ #include <omp.h>
+ #include <atomic>
+ #include <deque>
+ #include <set>
+
+ static const int STOP_TAG = 40;        ///< Message tag of the stop messages.
+ static const int STOP_ALL = -1;        ///< Payload of a stop-all message (else: a component index).
+
+ static bool pollFromAnyThread = false;
+ static std::atomic<bool> stopAll(false);
+ static std::atomic<bool> stopCurrent(false);
+ static std::atomic<bool> decidedAnnounced(false);
+ static int currentComponent = -1;
+ static std::vector<int> currentPeers;
+ static std::set<int> stoppedComponents;      // Components stopped before their search began.
+ static std::vector<long long> sentTo;        // Messages sent to each process.
+ static long long received = 0;
+ static std::deque<int> payloads;             // Send buffers, kept alive until completion.
+ static std::vector<MPI_Request> requests;
+
+ /**
+  * @brief Sends one stop message (caller holds the mpi critical section).
+  */
+ static void sendStop(int rank, int payload) {
+     payloads.push_back(payload);
+     requests.emplace_back();
+     MPI_Isend(&payloads.back(), 1, MPI_INT, rank, STOP_TAG, MPI_COMM_WORLD, &requests.back());
+     sentTo[rank]++;
+ }
+
+ /**
+  * @brief Handles one received stop message (caller holds the mpi critical section).
+  */
+ static void handleStop(int payload) {
+     received++;
+     if (payload == STOP_ALL)
+         stopAll = true;
+     else if (payload == currentComponent)
+         stopCurrent = true;
+     else
+         stoppedComponents.insert(payload);
+ }
+
+ /**
+  * @brief Initializes the stop signal (after MPI_Init_thread).
+  * @param serialized True if MPI provides MPI_THREAD_SERIALIZED.
+  */
+ void initStopSignal(bool serialized) {
+     int size;
+     MPI_Comm_size(MPI_COMM_WORLD, &size);
+     pollFromAnyThread = serialized;
+     sentTo.assign(size, 0);
+ }
+
+ /**
+  * @brief Marks the start of the search of a component.
+  * @param component Index of the component.
+  * @param peers The other processes searching the same component.
+  */
+ void beginComponentSearch(int component, const std::vector<int> &peers) {
+     #pragma omp critical(mpi)
+     {
+         currentComponent = component;
+         currentPeers = peers;
+         stopCurrent = stoppedComponents.count(component) > 0;
+         decidedAnnounced = false;
+     }
+ }
+
+ /**
+  * @brief Marks the end of the current component search.
+  */
+ void endComponentSearch() {
+     #pragma omp critical(mpi)
+     {
+         currentComponent = -1;
+         currentPeers.clear();
+         stopCurrent = false;
+     }
+ }
+
+ /**
+  * @brief Tells the peers of the current component that it is decided (once per search).
+  */
+ void announceComponentDecided() {
+     if (decidedAnnounced.exchange(true)) return;
+     if (!pollFromAnyThread && omp_get_thread_num() != 0) {
+         decidedAnnounced = false;  // Retried by the master thread.
+         return;
+     }
+     #pragma omp critical(mpi)
+     for (int rank : currentPeers)
+         sendStop(rank, currentComponent);
+ }
+
+ /**
+  * @brief Tells every process to stop searching.
+  */
+ void announceStopAll() {
+     int rank, size;
+     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+     MPI_Comm_size(MPI_COMM_WORLD, &size);
+     #pragma omp critical(mpi)
+     {
+         stopAll = true;
+         for (int r = 0; r < size; r++)
+             if (r != rank) sendStop(r, STOP_ALL);
+     }
+ }
+
+ /**
+  * @brief Receives the pending stop messages.
+  */
+ void pollStopSignal() {
+     if (!pollFromAnyThread && omp_get_thread_num() != 0) return;
+     #pragma omp critical(mpi)
+     {
+         int flag = 1;
+         while (flag) {
+             MPI_Status status;
+             MPI_Iprobe(MPI_ANY_SOURCE, STOP_TAG, MPI_COMM_WORLD, &flag, &status);
+             if (flag) {
+                 int payload;
+                 MPI_Recv(&payload, 1, MPI_INT, status.MPI_SOURCE, STOP_TAG, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+                 handleStop(payload);
+             }
+         }
+     }
+ }
+
+ /**
+  * @brief True if the current component search must stop because of a stop message.
+  */
+ bool searchStopped() {
+     return stopAll.load(std::memory_order_relaxed) || stopCurrent.load(std::memory_order_relaxed);
+ }
+
+ /**
+  * @brief True if a stop-all message was received (or sent) by this process.
+  */
+ bool stopAllReceived() {
+     return stopAll.load();
+ }
+
+ /**
+  * @brief Receives every stop message still in flight and completes the sends.
+  */
+ void finishStopSignal() {
+     int rank, size;
+     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+     MPI_Comm_size(MPI_COMM_WORLD, &size);
+     std::vector<long long> totalTo(size, 0);
+     MPI_Allreduce(sentTo.data(), totalTo.data(), size, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+     while (received < totalTo[rank]) {
+         int payload;
+         MPI_Recv(&payload, 1, MPI_INT, MPI_ANY_SOURCE, STOP_TAG, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+         handleStop(payload);
+     }
+     MPI_Waitall(static_cast<int>(requests.size()), requests.data(), MPI_STATUSES_IGNORE);
+     requests.clear();
+     payloads.clear();
+ }
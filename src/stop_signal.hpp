@@ -0,0 +1,74 @@
+/**
+ * @file stop_signal.hpp
+ * @brief Declaration of the cross-process stop signal used by the decision mode.
+ *
+ * A stop message either ends the search of one component on the processes sharing it
+ * (a k-coloring was found) or ends every search (a component is not k-colorable).
+ * Messages are sent without blocking and polled from the search every
+ * STOP_POLL_INTERVAL nodes; MPI is called under an OpenMP critical section, which is
+ * what MPI_THREAD_SERIALIZED requires.
+ */
+
+ #ifndef STOP_SIGNAL_HPP
+ #define STOP_SIGNAL_HPP
+
+ #include <vector>
+
+ /**
+  * @brief Number of search nodes of a process between two polls for stop messages.
+  */
+ const int STOP_POLL_INTERVAL = 256;
+
+ /**
+  * @brief Initializes the stop signal (after MPI_Init_thread).
+  * @param serialized True if MPI provides MPI_THREAD_SERIALIZED; otherwise only the
+  *                   master thread polls.
+  */
+ void initStopSignal(bool serialized);
+
+ /**
+  * @brief Marks the start of the search of a component.
+  * @param component Index of the component.
+  * @param peers The other processes searching the same component (world ranks).
+  */
+ void beginComponentSearch(int component, const std::vector<int> &peers);
+
+ /**
+  * @brief Marks the end of the current component search.
+  */
+ void endComponentSearch();
+
+ /**
+  * @brief Tells the peers of the current component that it is decided (once per search).
+  */
+ void announceComponentDecided();
+
+ /**
+  * @brief Tells every process to stop searching (e.g. the answer is known to be no).
+  */
+ void announceStopAll();
+
+ /**
+  * @brief Receives the pending stop messages (called from the search).
+  */
+ void pollStopSignal();
+
+ /**
+  * @brief True if the current component search must stop because of a stop message.
+  */
+ bool searchStopped();
+
+ /**
+  * @brief True if a stop-all message was received (or sent) by this process.
+  */
+ bool stopAllReceived();
+
+ /**
+  * @brief Receives every stop message still in flight and completes the sends.
+  *
+  * Collective over MPI_COMM_WORLD: the per-destination send counts are summed so that
+  * every process knows how many messages it still has to receive.
+  */
+ void finishStopSignal();
+
+ #endif // STOP_SIGNAL_HPP
@@ -0,0 +1,150 @@
+/**
+ * @file trace.cpp
+ * @brief Implementation of the optional timeline tracing.
+ */
+
+ #include "trace.hpp"
+ #include <atomic>
+ #include <chrono>
+ #include <memory>
+ #include <mutex>
+ #include <sstream>
+ #include <vector>
+
+ namespace {
+
+ /**
+  * @brief One recorded event.
+  */
+ struct TraceEvent {
+     const char *name;
+     const char *argName;  ///< nullptr: no argument.
+     long long arg;
+     double start;         ///< Microseconds since enableTracing().
+     double duration;      ///< Microseconds; negative for a counter event.
+ };
+
+ /**
+  * @brief The events of one thread; only the owning thread appends.
+  */
+ struct ThreadTrace {
+     int tid;
+     std::vector<TraceEvent> events;
+     long long dropped = 0;
+ };
+
+ std::atomic<bool> enabled(false);
+ std::chrono::steady_clock::time_point origin;
+ std::mutex registryMutex;
+ std::vector<std::shared_ptr<ThreadTrace>> registry;  // Every thread that recorded, in order of first use.
+ thread_local std::shared_ptr<ThreadTrace> threadTrace;
+
+ /**
+  * @brief Microseconds since enableTracing().
+  */
+ double now() {
+     return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - origin).count();
+ }
+
+ /**
+  * @brief Appends an event to the buffer of the calling thread.
+  */
+ void record(const TraceEvent &event) {
+     if (!threadTrace) {
+         auto t = std::make_shared<ThreadTrace>();
+         std::lock_guard<std::mutex> lock(registryMutex);
+         t->tid = static_cast<int>(registry.size());
+         registry.push_back(t);
+         threadTrace = std::move(t);
+     }
+     if (static_cast<int>(threadTrace->events.size()) >= TRACE_MAX_EVENTS_PER_THREAD)
+         threadTrace->dropped++;
+     else
+         threadTrace->events.push_back(event);
+ }
+
+ } // namespace
+
+ /**
+  * @brief Enables tracing for the whole process; timestamps count from this call.
+  */
+ void enableTracing() {
+     origin = std::chrono::steady_clock::now();
+     enabled = true;
+ }
+
+ /**
+  * @brief True if enableTracing() was called.
+  */
+ bool tracingEnabled() {
+     return enabled.load();
+ }
+
+ /**
+  * @brief Records the value of a counter track at the current time.
+  * @param name Name of the track.
+  * @param value The new value.
+  */
+ void traceCounter(const char *name, long long value) {
+     if (!enabled.load(std::memory_order_relaxed)) return;
+     record({name, "value", value, now(), -1.0});
+ }
+
+ /**
+  * @brief Serializes the events of every thread of this process.
+  * @param pid Process id of the events.
+  * @return Comma-separated JSON trace events.
+  */
+ std::string traceEventsJson(int pid) {
+     std::ostringstream out;
+     out.setf(std::ios::fixed);
+     out.precision(3);
+     out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid
+         << ",\"args\":{\"name\":\"rank " << pid << "\"}}";
+     std::lock_guard<std::mutex> lock(registryMutex);
+     for (const auto &t : registry) {
+         out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << t->tid
+             << ",\"args\":{\"name\":\"thread " << t->tid << "\"}}";
+         for (const TraceEvent &e : t->events) {
+             out << ",\n{\"name\":\"" << e.name << "\",\"pid\":" << pid << ",\"tid\":" << t->tid
+                 << ",\"ts\":" << e.start;
+             if (e.duration >= 0)
+                 out << ",\"ph\":\"X\",\"dur\":" << e.duration;
+             else
+                 out << ",\"ph\":\"C\"";
+             if (e.argName)
+                 out << ",\"args\":{\"" << e.argName << "\":" << e.arg << "}";
+             out << "}";
+         }
+     }
+     return out.str();
+ }
+
+ /**
+  * @brief Number of events dropped because a thread buffer was full.
+  */
+ long long traceDroppedEvents() {
+     std::lock_guard<std::mutex> lock(registryMutex);
+     long long dropped = 0;
+     for (const auto &t : registry)
+         dropped += t->dropped;
+     return dropped;
+ }
+
+ /**
+  * @brief Starts a span (records nothing if tracing is disabled).
+  */
+ TraceSpan::TraceSpan(const char *name_, const char *argName_, long long arg_)
+     : name(nullptr), argName(argName_), arg(arg_), start(0) {
+     if (!enabled.load(std::memory_order_relaxed)) return;
+     name = name_;
+     start = now();
+ }
+
+ /**
+  * @brief Ends the span and records it on the thread track.
+  */
+ TraceSpan::~TraceSpan() {
+     if (!name) return;
+     record({name, argName, arg, start, now() - start});
+ }
@@ -0,0 +1,75 @@
+/**
+ * @file trace.hpp
+ * @brief Declaration of the optional timeline tracing (Chrome trace / Perfetto JSON).
+ *
+ * Once enabled, TraceSpan scopes (search tasks, subproblems, components, the portfolio)
+ * and incumbent changes are recorded into a buffer per thread, without locking.
+ * traceEventsJson() serializes the buffers of the process as trace events with the
+ * given process id (the MPI rank) and one track per thread; the solver gathers them over
+ * all ranks into one file that chrome://tracing and ui.perfetto.dev open as is.
+ */
+
+ #ifndef TRACE_HPP
+ #define TRACE_HPP
+
+ #include <string>
+
+ /**
+  * @brief Largest number of events kept per thread; later events are counted as dropped.
+  */
+ const int TRACE_MAX_EVENTS_PER_THREAD = 1 << 20;
+
+ /**
+  * @brief Enables tracing for the whole process; timestamps count from this call.
+  *
+  * The solver calls it right after a barrier, so the timelines of the ranks line up.
+  */
+ void enableTracing();
+
+ /**
+  * @brief True if enableTracing() was called.
+  */
+ bool tracingEnabled();
+
+ /**
+  * @brief Records the value of a counter track (e.g. the incumbent) at the current time.
+  * @param name Name of the track (a string literal).
+  * @param value The new value.
+  */
+ void traceCounter(const char *name, long long value);
+
+ /**
+  * @brief Serializes the events of every thread of this process (call after the search).
+  * @param pid Process id of the events (the MPI rank).
+  * @return Comma-separated JSON trace events, including the process and thread names.
+  */
+ std::string traceEventsJson(int pid);
+
+ /**
+  * @brief Number of events dropped because a thread buffer was full.
+  */
+ long long traceDroppedEvents();
+
+ /**
+  * @brief Records the duration of a scope as one complete event on the thread track (if enabled).
+  */
+ class TraceSpan {
+ public:
+     /**
+      * @param name_ Name of the event (a string literal).
+      * @param argName_ Name of the argument shown with the event (a string literal), or nullptr.
+      * @param arg_ Value of the argument.
+      */
+     explicit TraceSpan(const char *name_, const char *argName_ = nullptr, long long arg_ = 0);
+     ~TraceSpan();
+     TraceSpan(const TraceSpan &) = delete;
+     TraceSpan &operator=(const TraceSpan &) = delete;
+
+ private:
+     const char *name;     ///< Name of the event, or nullptr if tracing is disabled.
+     const char *argName;
+     long long arg;
+     double start;         ///< Start time (microseconds since enableTracing()).
+ };
+
+ #endif // TRACE_HPP